@@ -82,7 +82,7 @@ endif()
 include(FindPackageHandleStandardArgs)
 find_package_handle_standard_args(FLINT DEFAULT_MSG FLINT_LIBRARY FLINT_INCLUDE_DIR)
 
-if(NOT TARGET flint)
+if(FLINT_FOUND AND NOT TARGET flint)
   add_library(flint UNKNOWN IMPORTED)
   set_target_properties(flint PROPERTIES IMPORTED_LOCATION ${FLINT_LIBRARY})
   target_include_directories(flint INTERFACE ${FLINT_INCLUDE_DIR})
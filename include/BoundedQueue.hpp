@@ -0,0 +1,100 @@
+#ifndef QECC_BOUNDEDQUEUE_HPP
+#define QECC_BOUNDEDQUEUE_HPP
+
+#include "QeccException.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * Bounded lock-free queue for multiple producers and consumers (Vyukov's sequence-number ring buffer)
+ * Each slot carries a sequence number that tells whether it is ready to be written or read in the current lap,
+ * so producers and consumers only contend on their own position counter
+ */
+template <class T>
+class BoundedQueue {
+public:
+    /**
+     * @param capacity number of slots, has to be a power of two
+     */
+    explicit BoundedQueue(const std::size_t capacity) : mask(capacity - 1), slots(std::make_unique<Slot[]>(capacity)) { // NOLINT(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+        if (capacity < 2U || (capacity & (capacity - 1)) != 0U) {
+            throw QeccException("Queue capacity must be a power of two");
+        }
+        for (std::size_t i = 0; i < capacity; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&)            = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * Moves the item into the queue unless it is full, in which case item is left untouched
+     * @return true if the item was enqueued
+     */
+    bool tryPush(T& item) {
+        auto pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            auto&      slot = slots[pos & mask];
+            const auto seq  = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(item);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // slot still holds an item of the previous lap
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Moves the oldest item out of the queue unless it is empty
+     * @return true if an item was dequeued
+     */
+    bool tryPop(T& item) {
+        auto pos = dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            auto&      slot = slots[pos & mask];
+            const auto seq  = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    item = std::move(slot.value);
+                    slot.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t capacity() const {
+        return mask + 1;
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0U};
+        T                        value{};
+    };
+
+    // the positions are written by different threads, keep them on separate cache lines
+    static constexpr std::size_t CACHE_LINE = 64U;
+
+    const std::size_t                     mask;
+    std::unique_ptr<Slot[]>               slots; // NOLINT(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+    alignas(CACHE_LINE) std::atomic<std::size_t> enqueuePos{0U};
+    alignas(CACHE_LINE) std::atomic<std::size_t> dequeuePos{0U};
+};
+#endif // QECC_BOUNDEDQUEUE_HPP
@@ -8,7 +8,10 @@
 #include "TreeNode.hpp"
 #include "Utils.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -23,14 +26,54 @@ struct CodeProperties {
     std::size_t d;
 };
 
+/**
+ * Non-owning view of a contiguous range of node indices in the Tanner graph
+ */
+struct NodeSpan {
+    const std::uint32_t* first = nullptr;
+    const std::uint32_t* last  = nullptr;
+
+    [[nodiscard]] const std::uint32_t* begin() const {
+        return first;
+    }
+    [[nodiscard]] const std::uint32_t* end() const {
+        return last;
+    }
+    [[nodiscard]] std::size_t size() const {
+        return static_cast<std::size_t>(last - first);
+    }
+    [[nodiscard]] bool empty() const {
+        return first == last;
+    }
+    [[nodiscard]] std::uint32_t front() const {
+        return *first;
+    }
+    [[nodiscard]] std::uint32_t back() const {
+        return *(last - 1);
+    }
+    std::uint32_t operator[](const std::size_t i) const {
+        return first[i]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+};
+
 struct ParityCheckMatrix {
-    std::unique_ptr<gf2Mat>                                   pcm;
-    std::unordered_map<std::size_t, std::vector<std::size_t>> nbrCache{};
+    std::unique_ptr<Gf2Matrix> pcm;
+    // Tanner graph in compressed form, built once when the matrix is set
+    std::vector<std::uint32_t> checkNbrOffsets{}; // CSR: check i -> bit nodes in checkNbrs[checkNbrOffsets[i], checkNbrOffsets[i+1])
+    std::vector<std::uint32_t> checkNbrs{};
+    std::vector<std::uint32_t> bitNbrOffsets{}; // CSC: bit j -> check nodes in bitNbrs[bitNbrOffsets[j], bitNbrOffsets[j+1])
+    std::vector<std::uint32_t> bitNbrs{};
 
     ParityCheckMatrix(const ParityCheckMatrix& m)          = delete;
     ParityCheckMatrix& operator=(const ParityCheckMatrix&) = delete;
 
-    explicit ParityCheckMatrix(gf2Mat& mat) : pcm(std::make_unique<gf2Mat>(mat)) {}
+    explicit ParityCheckMatrix(gf2Mat& mat) : pcm(std::make_unique<Gf2Matrix>(mat)) {
+        buildAdjacency();
+    }
+
+    explicit ParityCheckMatrix(const Gf2Matrix& mat) : pcm(std::make_unique<Gf2Matrix>(mat)) {
+        buildAdjacency();
+    }
 
     explicit ParityCheckMatrix(const std::string& filePath) {
         if (filePath.empty()) {
@@ -48,66 +91,310 @@ struct ParityCheckMatrix {
                 while (instream >> word) {
                     tempVec.push_back(static_cast<bool>(word));
                 }
-                result.emplace_back(tempVec);
+                if (!tempVec.empty()) {
+                    result.emplace_back(tempVec);
+                }
             }
-            pcm = std::make_unique<gf2Mat>(result);
+            pcm = std::make_unique<Gf2Matrix>(result);
         } catch (const std::exception& e) {
             std::cerr << "[PCM::ctor] - error opening file " << filePath << std::endl;
             throw QeccException(e.what());
         }
         inFile.close();
+        buildAdjacency();
+    }
+
+    /**
+     * Tanner graph given in compressed row form only, for decoding graphs that are too large to be stored as dense matrix
+     * The dense matrix pcm stays null, only the functions working on the adjacency can be used
+     * @param nrBitNodes number of bit nodes
+     * @param rowOffsets check i is adjacent to the bits in rowBits[rowOffsets[i], rowOffsets[i+1])
+     * @param rowBits bit indices, increasing per row
+     */
+    ParityCheckMatrix(const std::size_t nrBitNodes, std::vector<std::uint32_t> rowOffsets, std::vector<std::uint32_t> rowBits) : checkNbrOffsets(std::move(rowOffsets)),
+                                                                                                                                 checkNbrs(std::move(rowBits)) {
+        if (checkNbrOffsets.size() < 2U || checkNbrOffsets.back() != checkNbrs.size()) {
+            throw QeccException("Cannot build Tanner graph, adjacency empty or inconsistent");
+        }
+        if (checkNbrOffsets.size() - 1U + nrBitNodes > std::numeric_limits<std::uint32_t>::max()) {
+            throw QeccException("Cannot build Tanner graph, pcm too large for 32-bit indices");
+        }
+        if (std::any_of(checkNbrs.begin(), checkNbrs.end(), [&](const std::uint32_t j) { return j >= nrBitNodes; })) {
+            throw QeccException("Cannot build Tanner graph, bit index out of range");
+        }
+        buildBitAdjacency(nrBitNodes);
+    }
+
+    /**
+     * Deep copy, matrices without dense form are copied from their adjacency
+     */
+    [[nodiscard]] std::unique_ptr<ParityCheckMatrix> clone() const {
+        if (pcm) {
+            return std::make_unique<ParityCheckMatrix>(*pcm);
+        }
+        return std::make_unique<ParityCheckMatrix>(nrBits(), checkNbrOffsets, checkNbrs);
+    }
+
+    [[nodiscard]] std::size_t nrChecks() const {
+        return checkNbrOffsets.size() - 1U;
+    }
+
+    [[nodiscard]] std::size_t nrBits() const {
+        return bitNbrOffsets.size() - 1U;
     }
 
     /**
      * If H is nxm we have n checks and m bit nodes.
      * Indices of bit nodes range from 0 to m-1, and indices of check nodes from m to n-1
      * @param nodeIdx
-     * @return a list of node indices of adjacent nodes
+     * @return a view of the node indices of adjacent nodes, valid as long as the matrix is alive
+     */
+    [[nodiscard]] NodeSpan getNbrs(const std::size_t& nodeIdx) const {
+        const auto bits = bitNbrOffsets.size() - 1U;
+        if (nodeIdx < bits) {
+            return NodeSpan{bitNbrs.data() + bitNbrOffsets[nodeIdx], bitNbrs.data() + bitNbrOffsets[nodeIdx + 1U]};
+        }
+        const auto checkIdx = nodeIdx - bits;
+        if (checkIdx + 1U >= checkNbrOffsets.size()) {
+            std::cerr << "error getting nbrs for node " << nodeIdx << std::endl;
+            throw QeccException("Cannot return neighbours, node index out of range");
+        }
+        return NodeSpan{checkNbrs.data() + checkNbrOffsets[checkIdx], checkNbrs.data() + checkNbrOffsets[checkIdx + 1U]};
+    }
+
+    /**
+     * Computes H*err by adding the sparse columns of the flipped bits
+     * @param err bit-packed error of length nrBits()
+     * @return bit-packed syndrome of length nrChecks()
      */
-    std::vector<std::size_t> getNbrs(const std::size_t& nodeIdx) {
-        std::vector<std::size_t> result;
-        if (auto it = nbrCache.find(nodeIdx); it != nbrCache.end()) {
-            result = it->second;
-        } else {
-            if (pcm->empty() || pcm->front().empty()) {
-                std::cerr << "error getting nbrs for node " << nodeIdx << std::endl;
-                throw QeccException("Cannot return neighbours, pcm empty");
+    [[nodiscard]] Gf2Vector getSyndrome(const Gf2Vector& err) const {
+        if (err.size() != nrBits()) {
+            throw QeccException("Cannot compute syndrome, err empty or wrong size");
+        }
+        const auto bits = nrBits();
+        Gf2Vector  syndr(nrChecks());
+        err.forEachSetBit([&](const std::size_t j) {
+            for (auto i = bitNbrOffsets[j]; i < bitNbrOffsets[j + 1U]; i++) {
+                syndr.flip(bitNbrs[i] - bits);
             }
-            const auto               nrChecks = pcm->size();
-            const auto               nrBits   = pcm->front().size();
-            std::vector<std::size_t> res;
-            if (nodeIdx < nrBits) {
-                for (std::size_t i = 0; i < nrChecks; i++) {
-                    if (pcm->at(i).at(nodeIdx)) {
-                        res.emplace_back(nrBits + i);
-                    }
-                }
-            } else {
-                for (std::size_t i = 0; i < nrBits; i++) {
-                    if (pcm->at(nodeIdx - nrBits).at(i)) {
-                        res.emplace_back(i);
-                    }
-                }
+        });
+        return syndr;
+    }
+
+    /**
+     * Computes H*err for an error given by the indices of its flipped bits, e.g. from Utils::sampleSparseErrorIidPauliNoise
+     * Costs time proportional to the number of edges at the flipped bits, duplicate indices cancel
+     * @param support indices of the flipped bits
+     * @return bit-packed syndrome of length nrChecks()
+     */
+    [[nodiscard]] Gf2Vector getSyndromeFromSupport(const std::vector<std::size_t>& support) const {
+        Gf2Vector syndr(nrChecks());
+        for (const auto j : support) {
+            addColumnTo(j, syndr);
+        }
+        return syndr;
+    }
+
+    /**
+     * Adds column bit of H to the syndrome, i.e. updates the syndrome when the bit is flipped
+     * @param bit
+     * @param syndr bit-packed syndrome of length nrChecks()
+     */
+    void addColumnTo(const std::size_t bit, Gf2Vector& syndr) const {
+        const auto bits = nrBits();
+        if (bit >= bits) {
+            throw QeccException("Cannot compute syndrome, bit index out of range");
+        }
+        for (auto i = bitNbrOffsets[bit]; i < bitNbrOffsets[bit + 1U]; i++) {
+            syndr.flip(bitNbrs[i] - bits);
+        }
+    }
+
+    /**
+     * Bit-sliced syndrome computation for a batch of errors, one shot per bit lane
+     * @param errSlices one word per bit node, bit l is set iff the bit is flipped in shot l
+     * @return one word per check, bit l holds the check value in shot l
+     */
+    [[nodiscard]] std::vector<gf2Word> getBitslicedSyndrome(const std::vector<gf2Word>& errSlices) const {
+        if (errSlices.size() != nrBits()) {
+            throw QeccException("Cannot compute syndrome, err empty or wrong size");
+        }
+        const auto           bits = nrBits();
+        std::vector<gf2Word> syndr(nrChecks(), 0U);
+        for (std::size_t j = 0; j < bits; j++) {
+            const auto lanes = errSlices[j];
+            if (lanes == 0U) {
+                continue;
+            }
+            for (auto i = bitNbrOffsets[j]; i < bitNbrOffsets[j + 1U]; i++) {
+                syndr[bitNbrs[i] - bits] ^= lanes;
             }
-            const auto ins = nbrCache.try_emplace(nodeIdx, res);
-            result         = ins.first->second;
         }
-        return result;
+        return syndr;
     }
+
     [[nodiscard]] json to_json() const { // NOLINT(readability-identifier-naming)
+        if (!pcm) {
+            return json{{"nrChecks", nrChecks()}, {"nrBits", nrBits()}};
+        }
         return json{
-                {"pcm", *this->pcm}};
+                {"pcm", this->pcm->toBoolMatrix()}};
     }
 
     [[nodiscard]] std::string toString() const {
         return this->to_json().dump(2U);
     }
+
+private:
+    void buildAdjacency() {
+        if (pcm->empty()) {
+            throw QeccException("Cannot build Tanner graph, pcm empty");
+        }
+        const auto checks = pcm->rows();
+        const auto bits   = pcm->cols();
+        if (checks + bits > std::numeric_limits<std::uint32_t>::max()) {
+            throw QeccException("Cannot build Tanner graph, pcm too large for 32-bit indices");
+        }
+        checkNbrOffsets.assign(checks + 1U, 0U);
+        checkNbrs.clear();
+        checkNbrs.reserve(pcm->popcount());
+        // CSR directly from the rows
+        for (std::size_t i = 0; i < checks; i++) {
+            pcm->row(i).forEachSetBit([&](const std::size_t j) { checkNbrs.emplace_back(static_cast<std::uint32_t>(j)); });
+            checkNbrOffsets[i + 1U] = static_cast<std::uint32_t>(checkNbrs.size());
+        }
+        buildBitAdjacency(bits);
+    }
+
+    void buildBitAdjacency(const std::size_t bits) {
+        const auto checks = checkNbrOffsets.size() - 1U;
+        bitNbrOffsets.assign(bits + 1U, 0U);
+        for (const auto j : checkNbrs) {
+            bitNbrOffsets[j + 1U]++;
+        }
+        for (std::size_t j = 0; j < bits; j++) {
+            bitNbrOffsets[j + 1U] += bitNbrOffsets[j];
+        }
+        // CSC by scattering the CSR entries, check indices are increasing per column
+        bitNbrs.assign(checkNbrs.size(), 0U);
+        std::vector<std::uint32_t> fill(bitNbrOffsets.begin(), bitNbrOffsets.end() - 1);
+        for (std::size_t i = 0; i < checks; i++) {
+            for (auto k = checkNbrOffsets[i]; k < checkNbrOffsets[i + 1U]; k++) {
+                bitNbrs[fill[checkNbrs[k]]++] = static_cast<std::uint32_t>(bits + i);
+            }
+        }
+    }
+};
+
+/**
+ * Precomputed data to decide whether a vector lies in the rowspace of a stabilizer matrix S (the X or Z checks of a code)
+ * given the check matrix H of the opposite type.
+ * If S H^T = 0, a vector v lies in the rowspace of S iff Hv = 0 and v commutes with a basis of the logicals ker(S)/rowspace(H).
+ * This needs only the sparse syndrome and k inner products. Otherwise the reduced row echelon form of S is used.
+ */
+struct StabilizerSpace {
+    Gf2Matrix                logicals{};
+    Gf2Matrix                reduced{}; // S in reduced row echelon form, the first pivots.size() rows are non-zero
+    std::vector<std::size_t> pivots{};
+    bool                     commuting = false;
+
+    StabilizerSpace(const ParityCheckMatrix& stabs, const ParityCheckMatrix& checks) : reduced(*stabs.pcm) {
+        pivots = reduced.rref();
+
+        commuting = true;
+        for (std::size_t i = 0; i < stabs.nrChecks() && commuting; i++) {
+            commuting = checks.getSyndrome(stabs.pcm->row(i)).none();
+        }
+        if (!commuting) {
+            return;
+        }
+        // extend a reduced basis of rowspace(H) by the kernel vectors of S that are independent of it
+        auto       hRref       = *checks.pcm;
+        auto       basisPivots = hRref.rref();
+        const auto kernel      = stabs.pcm->nullspace();
+        Gf2Matrix  basis(basisPivots.size() + kernel.rows(), hRref.cols());
+        for (std::size_t i = 0; i < basisPivots.size(); i++) {
+            basis.copyRowFrom(i, hRref, i);
+        }
+        std::vector<std::size_t> logicalRows;
+        for (std::size_t r = 0; r < kernel.rows(); r++) {
+            auto vec = kernel.row(r);
+            for (std::size_t i = 0; i < basisPivots.size(); i++) {
+                if (vec.get(basisPivots[i])) {
+                    vec ^= basis.row(i);
+                }
+            }
+            if (vec.none()) {
+                continue;
+            }
+            // keep the basis reduced: eliminate the new pivot from all other basis rows
+            std::size_t newPivot = 0U;
+            while (!vec.get(newPivot)) {
+                newPivot++;
+            }
+            const auto newRow = basisPivots.size();
+            basis.setRow(newRow, vec);
+            for (std::size_t i = 0; i < newRow; i++) {
+                if (basis.get(i, newPivot)) {
+                    basis.addRow(newRow, i);
+                }
+            }
+            basisPivots.emplace_back(newPivot);
+            logicalRows.emplace_back(r);
+        }
+        logicals = Gf2Matrix(logicalRows.size(), kernel.cols());
+        for (std::size_t i = 0; i < logicalRows.size(); i++) {
+            logicals.copyRowFrom(i, kernel, logicalRows[i]);
+        }
+    }
+
+    /**
+     * Checks if vec is in the rowspace of S
+     * @param vec
+     * @param checks the opposite check matrix H given at construction
+     * @return
+     */
+    [[nodiscard]] bool contains(const Gf2Vector& vec, const ParityCheckMatrix& checks) const {
+        if (vec.none()) {
+            return true;
+        }
+        if (commuting) {
+            if (checks.getSyndrome(vec).any()) {
+                return false;
+            }
+            for (std::size_t i = 0; i < logicals.rows(); i++) {
+                if (logicals.rowDot(i, vec)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        auto rem = vec;
+        for (std::size_t i = 0; i < pivots.size(); i++) {
+            if (rem.get(pivots[i])) {
+                rem ^= reduced.row(i);
+            }
+        }
+        return rem.none();
+    }
 };
 
 class Code {
 private:
     std::unique_ptr<ParityCheckMatrix> hX;
     std::unique_ptr<ParityCheckMatrix> hZ;
+    // computed once both pcms are set, immutable and hence shared between copies
+    std::shared_ptr<const StabilizerSpace> xStabilizers; // rowspace of hX, decides if X residuals are stabilizers
+    std::shared_ptr<const StabilizerSpace> zStabilizers; // rowspace of hZ, decides if Z residuals are stabilizers
+
+    void initStabilizerSpaces() {
+        xStabilizers.reset();
+        zStabilizers.reset();
+        if (hX && hZ && hX->nrBits() == hZ->nrBits()) {
+            xStabilizers = std::make_shared<const StabilizerSpace>(*hX, *hZ);
+            zStabilizers = std::make_shared<const StabilizerSpace>(*hZ, *hX);
+        }
+    }
 
 public:
     std::size_t n = 0U;
@@ -119,30 +406,55 @@ public:
     }
 
     Code() = default;
+
+    /**
+     * Copies the pcms, the precomputed stabilizer spaces are shared
+     * @param other
+     */
+    Code(const Code& other) : hX(other.hX ? other.hX->clone() : nullptr),
+                              hZ(other.hZ ? other.hZ->clone() : nullptr),
+                              xStabilizers(other.xStabilizers), zStabilizers(other.zStabilizers),
+                              n(other.n), k(other.k), d(other.d) {}
+
     [[nodiscard]] const std::unique_ptr<ParityCheckMatrix>& gethZ() const {
         return hZ;
     }
 
     gf2Mat getHxMat() {
-        return *this->hX->pcm;
+        return this->hX->pcm->toBoolMatrix();
     }
 
     gf2Mat getHzMat() {
-        return *this->hZ->pcm;
+        return this->hZ->pcm->toBoolMatrix();
     }
 
     void setHx(std::vector<std::vector<bool>>& hx) {
         hX = std::make_unique<ParityCheckMatrix>(hx);
+        initStabilizerSpaces();
     }
 
     void setHz(std::vector<std::vector<bool>>& hz) {
         hZ = std::make_unique<ParityCheckMatrix>(hz);
+        initStabilizerSpaces();
     }
     /*
      * Takes matrix hZ over GF(2) and constructs respective code for X errors with Z checks represented by hZ
      * Convention: Rows in first dim, columns in second
      */
-    explicit Code(std::vector<std::vector<bool>>& hz) : hZ(std::make_unique<ParityCheckMatrix>(hz)), n(hZ->pcm->front().size()) {
+    explicit Code(std::vector<std::vector<bool>>& hz) : hZ(std::make_unique<ParityCheckMatrix>(hz)), n(hZ->pcm->cols()) {
+    }
+
+    explicit Code(const Gf2Matrix& hz) : hZ(std::make_unique<ParityCheckMatrix>(hz)), n(hZ->pcm->cols()) {
+    }
+
+    /**
+     * Code for X errors with a given Tanner graph, which need not have a dense matrix, e.g. a decoding graph
+     */
+    explicit Code(std::unique_ptr<ParityCheckMatrix> hz) : hZ(std::move(hz)) {
+        if (!hZ) {
+            throw QeccException("[Code::ctor] - Cannot construct Code, hZ empty");
+        }
+        n = hZ->nrBits();
     }
 
     /*
@@ -151,7 +463,14 @@ public:
      */
     explicit Code(std::vector<std::vector<bool>>& hx, std::vector<std::vector<bool>>& hz) : hX(std::make_unique<ParityCheckMatrix>(hx)),
                                                                                             hZ(std::make_unique<ParityCheckMatrix>(hz)),
-                                                                                            n(hZ->pcm->front().size()) {
+                                                                                            n(hZ->pcm->cols()) {
+        initStabilizerSpaces();
+    }
+
+    explicit Code(const Gf2Matrix& hx, const Gf2Matrix& hz) : hX(std::make_unique<ParityCheckMatrix>(hx)),
+                                                              hZ(std::make_unique<ParityCheckMatrix>(hz)),
+                                                              n(hZ->pcm->cols()) {
+        initStabilizerSpaces();
     }
 
     /**
@@ -159,21 +478,22 @@ public:
      * @param pathToPcm
      */
     explicit Code(const std::string& pathToPcm) : hZ(std::make_unique<ParityCheckMatrix>(pathToPcm)) {
-        if (hZ->pcm->empty() || hZ->pcm->front().empty()) {
+        if (hZ->pcm->empty()) {
             throw QeccException("[Code::ctor] - Cannot construct Code, hZ empty");
         }
-        n = hZ->pcm->front().size();
+        n = hZ->pcm->cols();
     }
 
     explicit Code(const std::string& pathTohX, const std::string& pathTohZ) : hX(std::make_unique<ParityCheckMatrix>(pathTohX)), hZ(std::make_unique<ParityCheckMatrix>(pathTohZ)) {
-        if (hZ->pcm->empty() || hZ->pcm->front().empty() || hX->pcm->empty() || hX->pcm->front().empty()) {
+        if (hZ->pcm->empty() || hX->pcm->empty()) {
             throw QeccException("[Code::ctor] - Cannot construct Code, hX or hZ empty");
         }
-        n = hZ->pcm->front().size();
+        n = hZ->pcm->cols();
         // todo hXhZ^T=0
-        if (!hX->pcm || !hZ->pcm || hX->pcm->front().size() != hZ->pcm->front().size()) {
+        if (!hX->pcm || !hZ->pcm || hX->pcm->cols() != hZ->pcm->cols()) {
             throw QeccException("[Code::ctor] - hX and hZ dimensions do not match");
         }
+        initStabilizerSpaces();
     }
 
     [[nodiscard]] std::size_t getN() const {
@@ -203,9 +523,19 @@ public:
             return getSyndrome(xerr, zerr);
         }
         // per default X errs only
-        gf2Vec syndr((*hZ->pcm).size(), false);
-        Utils::rectMatrixMultiply(*hZ->pcm, err, syndr);
-        return syndr;
+        return getXSyndrome(Gf2Vector(err)).toBoolVector();
+    }
+
+    /**
+     * Returns the syndrome of a bit-packed X-error of length n
+     * @param err
+     * @return
+     */
+    [[nodiscard]] Gf2Vector getXSyndrome(const Gf2Vector& err) const {
+        if (err.size() != this->getN()) {
+            throw QeccException("Cannot compute syndrome, err empty or wrong size");
+        }
+        return hZ->getSyndrome(err);
     }
 
     /**
@@ -218,30 +548,60 @@ public:
             throw QeccException("Cannot compute syndrome, err empty or wrong size");
         }
 
-        gf2Vec xsyndr((*hZ->pcm).size(), false);
-        Utils::rectMatrixMultiply(*hZ->pcm, xerr, xsyndr);
-
-        gf2Vec zsyndr((*hX->pcm).size(), false);
-        Utils::rectMatrixMultiply(*hX->pcm, zerr, zsyndr);
-        gf2Vec res;
+        const auto xsyndr = hZ->getSyndrome(Gf2Vector(xerr));
+        const auto zsyndr = hX->getSyndrome(Gf2Vector(zerr));
+        gf2Vec     res    = xsyndr.toBoolVector();
         res.reserve(xsyndr.size() + zsyndr.size());
-        std::move(xsyndr.begin(), xsyndr.end(), std::back_inserter(res));
-        std::move(zsyndr.begin(), zsyndr.end(), std::back_inserter(res));
+        const auto zres = zsyndr.toBoolVector();
+        std::copy(zres.begin(), zres.end(), std::back_inserter(res));
         return res;
     }
 
+    /**
+     * Basis of the Z-type logical operators ker(hX)/rowspace(hZ), an X residual without syndrome is a stabilizer iff it commutes with all of them
+     * Empty if the code is single-sided or its checks do not commute
+     */
+    [[nodiscard]] Gf2Matrix getZLogicals() const {
+        return xStabilizers ? xStabilizers->logicals : Gf2Matrix{};
+    }
+
+    /**
+     * Basis of the X-type logical operators ker(hZ)/rowspace(hX)
+     * Empty if the code is single-sided or its checks do not commute
+     */
+    [[nodiscard]] Gf2Matrix getXLogicals() const {
+        return zStabilizers ? zStabilizers->logicals : Gf2Matrix{};
+    }
+
     /**
      * Checks if the given vector is a X stabilizer of the code
      * @param est
      * @return
      */
     [[nodiscard]] bool isXStabilizer(const gf2Vec& est) const {
+        return isXStabilizer(Gf2Vector(est));
+    }
+
+    [[nodiscard]] bool isXStabilizer(const Gf2Vector& est) const {
         if (!hX) {
             throw QeccException("hX not set, cannot check if vector is a stabilizer");
         }
+        if (xStabilizers) {
+            return xStabilizers->contains(est, *hZ);
+        }
         return Utils::isVectorInRowspace(*hX->pcm, est);
     }
 
+    [[nodiscard]] bool isZStabilizer(const Gf2Vector& est) const {
+        if (!hZ) {
+            throw QeccException("hZ not set, cannot check if vector is a stabilizer");
+        }
+        if (zStabilizers) {
+            return zStabilizers->contains(est, *hX);
+        }
+        return Utils::isVectorInRowspace(*hZ->pcm, est);
+    }
+
     /**
      * Determines if the given vector represented as two components, X and Z
      * Is a stabilizer
@@ -250,7 +610,7 @@ public:
      * @return
      */
     [[nodiscard]] bool isStabilizer(const gf2Vec& xest, const gf2Vec& zest) const {
-        return Utils::isVectorInRowspace(*hX->pcm, xest) && Utils::isVectorInRowspace(*hZ->pcm, zest);
+        return isXStabilizer(Gf2Vector(xest)) && isZStabilizer(Gf2Vector(zest));
     }
 
     /**
@@ -271,9 +631,9 @@ public:
             zEst.reserve(getN());
             std::move(est.begin(), est.begin() + static_cast<std::int64_t>(est.size()) / 2, std::back_inserter(xEst));
             std::move(est.begin() + static_cast<std::int64_t>(est.size()) / 2, est.end(), std::back_inserter(zEst));
-            return Utils::isVectorInRowspace(*hX->pcm, xEst) && Utils::isVectorInRowspace(*hZ->pcm, zEst);
+            return isStabilizer(xEst, zEst);
         }
-        return Utils::isVectorInRowspace(*hX->pcm, est);
+        return isXStabilizer(Gf2Vector(est));
     }
 
     [[nodiscard]] CodeProperties getProperties() const {
@@ -282,8 +642,8 @@ public:
     }
 
     friend std::ostream& operator<<(std::ostream& os, const Code& c) {
-        auto   nrChecks = c.hZ->pcm->size();
-        auto   nrData   = c.hZ->pcm->front().size();
+        auto   nrChecks = c.hZ->pcm->rows();
+        auto   nrData   = c.hZ->pcm->cols();
         auto   dim      = nrChecks + nrData;
         gf2Mat res(dim);
         os << "hZ: " << std::endl;
@@ -291,11 +651,11 @@ public:
             gf2Vec row(dim);
             if (i < dim - nrChecks) {
                 for (size_t j = 0; j < nrChecks; j++) {
-                    row.at(nrData + j) = c.hZ->pcm->at(j).at(i);
+                    row.at(nrData + j) = c.hZ->pcm->get(j, i);
                 }
             } else {
                 for (size_t j = 0; j < nrData; j++) {
-                    row.at(j) = c.hZ->pcm->at(i - nrData).at(j);
+                    row.at(j) = c.hZ->pcm->get(i - nrData, j);
                 }
             }
             res.at(i) = row;
@@ -306,11 +666,11 @@ public:
                 gf2Vec row(dim);
                 if (i < dim - nrChecks) {
                     for (size_t j = 0; j < nrChecks; j++) {
-                        row.at(nrData + j) = c.hX->pcm->at(j).at(i);
+                        row.at(nrData + j) = c.hX->pcm->get(j, i);
                     }
                 } else {
                     for (size_t j = 0; j < nrData; j++) {
-                        row.at(j) = c.hX->pcm->at(i - nrData).at(j);
+                        row.at(j) = c.hX->pcm->get(i - nrData, j);
                     }
                 }
                 res.at(i) = row;
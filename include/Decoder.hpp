@@ -5,9 +5,12 @@
 #define QUNIONFIND_DECODER_HPP
 #include "Code.hpp"
 #include "Codes.hpp"
+#include "PhaseTimer.hpp"
+#include "SyndromeLookupTable.hpp"
 #include "TreeNode.hpp"
 
 #include <chrono>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <utility>
 #include <vector>
@@ -19,7 +22,8 @@ enum class GrowthVariant {
     InvalidComponents,
     SingleSmallest,
     SingleRandom,
-    SingleQubitRandom
+    SingleQubitRandom,
+    Weighted // invalid components grow towards qubits in order of their error probability, UFHeuristic only
 };
 
 [[maybe_unused]] static GrowthVariant growthVariantFromString(const std::string& architecture) {
@@ -38,6 +42,9 @@ enum class GrowthVariant {
     if (architecture == "SINGLE_QUBIT_RANDOM" || architecture == "4") {
         return GrowthVariant::SingleQubitRandom;
     }
+    if (architecture == "WEIGHTED" || architecture == "5") {
+        return GrowthVariant::Weighted;
+    }
     throw std::invalid_argument("Invalid growth variant: " + architecture);
 }
 
@@ -45,28 +52,49 @@ NLOHMANN_JSON_SERIALIZE_ENUM(GrowthVariant, {{GrowthVariant::AllComponents, "all
                                              {GrowthVariant::InvalidComponents, "invalid components"},
                                              {GrowthVariant::SingleSmallest, "smallest component only"},
                                              {GrowthVariant::SingleQubitRandom, "single random qubit only"},
-                                             {GrowthVariant::SingleRandom, "single random component"}})
+                                             {GrowthVariant::SingleRandom, "single random component"},
+                                             {GrowthVariant::Weighted, "weighted"}})
 struct DecodingResult {
     std::size_t              decodingTime       = 0U; // in ms
+    std::uint64_t            decodingNanos      = 0U; // same as decodingTime in ns, short decodes truncate to 0 ms
+    PhaseTimings             phaseNanos         = {}; // only recorded if PHASE_TIMING_ENABLED
     std::vector<std::size_t> estimNodeIdxVector = {};
     gf2Vec                   estimBoolVector    = {};
+    bool                     matchesSyndrome    = true; // false if the decoder found no estimate with the given syndrome
 
     [[nodiscard]] json to_json() const { // NOLINT(readability-identifier-naming)
-        return json{{"decodingTime(ms)", decodingTime},
-                    {"estimate", Utils::getStringFrom(estimBoolVector)}};
+        json res{{"decodingTime(ms)", decodingTime},
+                 {"decodingTime(ns)", decodingNanos},
+                 {"estimate", Utils::getStringFrom(estimBoolVector)},
+                 {"matchesSyndrome", matchesSyndrome}};
+        if (PHASE_TIMING_ENABLED) {
+            res["phaseTimes(ns)"] = phaseNanos.to_json();
+        }
+        return res;
     }
     void from_json(const json& j) { // NOLINT(readability-identifier-naming)
         j.at("decodingTime(ms)").get_to(decodingTime);
+        if (j.contains("decodingTime(ns)")) {
+            j.at("decodingTime(ns)").get_to(decodingNanos);
+        }
         j.at("estimate").get_to(estimBoolVector);
+        if (j.contains("matchesSyndrome")) {
+            j.at("matchesSyndrome").get_to(matchesSyndrome);
+        }
         j.at("estimatedNodes").get_to(estimNodeIdxVector);
     }
     [[nodiscard]] std::string toString() const {
         return this->to_json().dump(2U);
     }
+    void setDecodingTime(const std::chrono::steady_clock::duration elapsed) {
+        decodingNanos = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        decodingTime  = static_cast<std::size_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+    }
 };
 class Decoder {
 private:
-    std::unique_ptr<Code> code;
+    std::shared_ptr<const Code>                code;        // immutable and shared between decoders, no per-shot copies
+    std::shared_ptr<const SyndromeLookupTable> lookupTable; // consulted before clustering, dropped when the code changes
 
 public:
     DecodingResult result{};
@@ -76,7 +104,7 @@ public:
     virtual void decode(const std::vector<bool>&){}; // NOLINT(readability-named-parameter)
     virtual ~Decoder() = default;
 
-    [[nodiscard]] const std::unique_ptr<Code>& getCode() const {
+    [[nodiscard]] const std::shared_ptr<const Code>& getCode() const {
         return code;
     }
     [[nodiscard]] GrowthVariant getGrowth() const {
@@ -85,13 +113,40 @@ public:
     void setGrowth(GrowthVariant g) {
         Decoder::growth = g;
     }
-    void setCode(Code& c) {
-        if (c.gethX() == nullptr) {
-            this->code = std::make_unique<Code>(*c.gethZ()->pcm);
-        } else {
-            this->code = std::make_unique<Code>(*c.gethZ()->pcm, *c.gethX()->pcm);
+    /**
+     * Copies the given code once, prefer sharing a code handle if several decoders work on the same code
+     * @param c
+     */
+    void setCode(const Code& c) {
+        this->code = std::make_shared<const Code>(c);
+        lookupTable.reset();
+    }
+    void setCode(std::shared_ptr<const Code> c) {
+        this->code = std::move(c);
+        lookupTable.reset();
+    }
+    /**
+     * Sets a table of corrections of low-weight syndromes, looked up before clusters are grown
+     * Tables are immutable and can be shared between decoders of the same code
+     * @param table built from hZ of the code of the decoder, null to disable
+     */
+    void setLookupTable(std::shared_ptr<const SyndromeLookupTable> table) {
+        if (table != nullptr && (code == nullptr || !table->matches(*code->gethZ()))) {
+            throw QeccException("Lookup table was not built for the code of the decoder");
         }
+        lookupTable = std::move(table);
+    }
+    [[nodiscard]] const std::shared_ptr<const SyndromeLookupTable>& getLookupTable() const {
+        return lookupTable;
     }
     virtual void reset(){};
+
+protected:
+    /**
+     * Looks up the correction if a table is set and the syndrome belongs to hZ, which the table is built from
+     */
+    bool lookupCorrection(const Gf2Vector& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm, std::vector<std::size_t>& correction) const {
+        return lookupTable != nullptr && pcm.get() == code->gethZ().get() && lookupTable->lookup(syndrome, *pcm, correction);
+    }
 };
 #endif // QUNIONFIND_DECODER_HPP
@@ -6,12 +6,27 @@
 #define QECC_DECODINGSIMULATOR_HPP
 
 #include "Decoder.hpp"
+#include "LatencyHistogram.hpp"
 #include "UFHeuristic.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 using json = nlohmann::json;
 
+/**
+ * Encoding of per shot statistics, see ResultsSink.hpp
+ */
+enum class ResultsFormat {
+    Ndjson,  // one line of json per shot
+    Columnar // binary columns, readable with mqt.qecc.load_results
+};
+
 enum DecoderType {
     UfHeuristic,
     UfDecoder
@@ -28,6 +43,159 @@ enum DecoderType {
 NLOHMANN_JSON_SERIALIZE_ENUM(DecoderType, {{UfHeuristic, "UF_HEURISTIC"}, // NOLINT(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
                                            {UfDecoder, "UF_DECODER"}})
 
+/**
+ * Stopping rule for the adaptive WER estimation at a single physical error rate
+ * Sampling stops as soon as one of the targets or caps is reached, targets set to 0 are disabled
+ */
+struct StoppingCriteria {
+    std::size_t targetFailures      = 100U;     // number of logical failures after which the estimate is considered precise enough
+    double      targetRelativeWidth = 0.0;      // width of the confidence interval relative to the estimate
+    std::size_t maxShots            = 1000000U; // cap on the number of shots, has to be positive
+    double      maxSeconds          = 0.0;      // cap on the wall time in seconds
+    double      z                   = 1.96;     // standard normal quantile of the interval, 1.96 for 95% confidence
+};
+
+/**
+ * Word error rate estimated at one physical error rate together with its Wilson score interval
+ */
+struct WerEstimate {
+    double      physicalErrRate = 0.0;
+    std::size_t shots           = 0U;
+    std::size_t failures        = 0U;
+    double      wordErrRate     = 0.0;
+    double      lower           = 0.0;
+    double      upper           = 0.0;
+    double      seconds         = 0.0; // wall time spent on this error rate
+
+    [[nodiscard]] json to_json() const { // NOLINT(readability-identifier-naming)
+        return json{{"physicalErrRate", physicalErrRate},
+                    {"shots", shots},
+                    {"failures", failures},
+                    {"wordErrRate", wordErrRate},
+                    {"lower", lower},
+                    {"upper", upper},
+                    {"seconds", seconds}};
+    }
+    [[nodiscard]] std::string toString() const {
+        return this->to_json().dump(2U);
+    }
+};
+
+/**
+ * Failures of a decoder on errors of a fixed weight
+ * If exact, all C(n, weight) errors of this weight were decoded and failures / shots is the exact conditional failure rate
+ */
+struct WeightStratum {
+    std::size_t weight   = 0U;
+    std::size_t shots    = 0U;
+    std::size_t failures = 0U;
+    bool        exact    = false;
+
+    [[nodiscard]] json to_json() const { // NOLINT(readability-identifier-naming)
+        return json{{"weight", weight},
+                    {"shots", shots},
+                    {"failures", failures},
+                    {"exact", exact}};
+    }
+};
+
+/**
+ * Conditional failure rates f(w) of a decoder for X-errors of weight w = 0, ..., maxWeight
+ * For iid noise the block error rate is the binomial mixture sum_w C(n,w) p^w (1-p)^(n-w) f(w),
+ * hence one set of strata gives the WER at any physical error rate
+ */
+struct WeightStrata {
+    std::size_t                n = 0U;
+    std::size_t                k = 1U;
+    std::vector<WeightStratum> strata{}; // indexed by weight
+
+    /**
+     * Evaluates the binomial mixture at the given physical error rate
+     * The interval combines the Wilson intervals of the sampled strata, exact strata contribute no uncertainty.
+     * The probability mass of weights above the largest stratum is counted as failure for the upper bound and
+     * as success for the lower bound, the point estimate extrapolates the failure rate of the largest stratum
+     * @param physicalErrRate
+     * @param z standard normal quantile of the per stratum intervals
+     * @return estimate with the shots and failures summed over all strata
+     */
+    [[nodiscard]] WerEstimate estimate(double physicalErrRate, double z = 1.96) const;
+
+    /**
+     * Probability C(n,w) p^w (1-p)^(n-w) that an iid error on n qubits has weight w, computed in log space
+     */
+    [[nodiscard]] double binomialWeight(const std::size_t w, const double p) const {
+        if (p <= 0.0 || p >= 1.0) {
+            return static_cast<double>((p <= 0.0 && w == 0U) || (p >= 1.0 && w == n));
+        }
+        const auto nd = static_cast<double>(n);
+        const auto wd = static_cast<double>(w);
+        return std::exp(std::lgamma(nd + 1.0) - std::lgamma(wd + 1.0) - std::lgamma(nd - wd + 1.0) + wd * std::log(p) + (nd - wd) * std::log1p(-p));
+    }
+
+    [[nodiscard]] json to_json() const { // NOLINT(readability-identifier-naming)
+        json js = json::array();
+        for (const auto& s : strata) {
+            js.emplace_back(s.to_json());
+        }
+        return json{{"n", n}, {"k", k}, {"strata", js}};
+    }
+};
+
+/**
+ * Decoder and growth variant to be compared by DecodingSimulator::compareDecoders
+ */
+struct DecoderConfig {
+    DecoderType   decoderType = DecoderType::UfHeuristic;
+    GrowthVariant growth      = GrowthVariant::AllComponents;
+
+    [[nodiscard]] json to_json() const { // NOLINT(readability-identifier-naming)
+        return json{{"decoderType", decoderType},
+                    {"growth", growth}};
+    }
+};
+
+/**
+ * Paired statistics of several decoder configurations that decoded the same shots
+ * Since all configurations see identical errors, differences in failures are resolved with far fewer shots than with independent runs
+ */
+struct DecoderComparison {
+    double                                physicalErrRate = 0.0;
+    std::size_t                           shots           = 0U;
+    std::size_t                           decoded         = 0U; // shots with nontrivial syndrome, the others are not decoded
+    std::vector<DecoderConfig>            configs{};
+    std::vector<std::size_t>              failures{};      // per configuration
+    std::vector<std::uint64_t>            decodingNanos{}; // total time spent in decode per configuration
+    std::vector<std::vector<std::size_t>> onlyFailed{};    // onlyFailed[i][j] counts the shots on which i failed and j succeeded
+
+    /**
+     * Number of shots on which exactly one of the two configurations failed
+     */
+    [[nodiscard]] std::size_t disagreements(const std::size_t i, const std::size_t j) const {
+        return onlyFailed.at(i).at(j) + onlyFailed.at(j).at(i);
+    }
+
+    [[nodiscard]] double meanLatencyNanos(const std::size_t i) const {
+        return decoded == 0U ? 0.0 : static_cast<double>(decodingNanos.at(i)) / static_cast<double>(decoded);
+    }
+
+    [[nodiscard]] json to_json() const { // NOLINT(readability-identifier-naming)
+        json js = json::array();
+        for (std::size_t i = 0; i < configs.size(); i++) {
+            js.emplace_back(json{{"config", configs[i].to_json()},
+                                 {"failures", failures[i]},
+                                 {"meanLatency(ns)", meanLatencyNanos(i)},
+                                 {"onlyFailed", onlyFailed[i]}});
+        }
+        return json{{"physicalErrRate", physicalErrRate},
+                    {"shots", shots},
+                    {"decoded", decoded},
+                    {"configs", js}};
+    }
+    [[nodiscard]] std::string toString() const {
+        return this->to_json().dump(2U);
+    }
+};
+
 class DecodingSimulator {
 public:
     /**
@@ -38,39 +206,194 @@ public:
      * the field code is set in the given @decoder.
      * Results are written to the two output files specified.
      * @param rawDataOutputFilepath path to file to write raw output data in the form [physicalErrorRate:WER] to
-     * @param statsOutputFilepath path to file to write statistics of decoding run to (@DecodingRunInformation)
+     * @param statsOutputFilepath path to file to write one line of json per shot to (@ShotRecord), written asynchronously with sparse vectors
      * @param minPhysicalErrRate starting physical error rate
      * @param maxPhysicalErrRate maximum physical error rate
      * @param physErrRateStepSize stepsize between error rates
      * @param nrRunsPerRate number of runs to average WER over
      * @param decoder
+     * @param nrThreads number of threads that decode in parallel, each with its own decoder, 0 uses all hardware threads
+     * @param seed if given, the sampled errors and hence the results only depend on the seed and not on nrThreads
+     * @param statsFormat encoding of the per shot statistics, newline delimited json or a directory of binary columns
+     * If raw data is written, the latency histogram of the decoded shots of each rate is written to a latency file next to it
+     */
+    static void simulateWER(const std::string&                  rawDataOutputFilepath,
+                            const std::string&                  statsOutputFilepath,
+                            double                              minPhysicalErrRate,
+                            double                              maxPhysicalErrRate,
+                            std::size_t                         nrRunsPerRate,
+                            Code&                               code,
+                            double                              perStepSize,
+                            const DecoderType&                  decoderType, // code is field of decoder
+                            std::size_t                         nrThreads   = 1U,
+                            const std::optional<std::uint64_t>& seed        = std::nullopt,
+                            ResultsFormat                       statsFormat = ResultsFormat::Ndjson);
+
+    /**
+     * Same sweep over physical error rates as simulateWER, but instead of a fixed number of runs per rate
+     * each rate is sampled until the given stopping criteria are met. Shots are taken in rounds of growing size, so that rates
+     * with many failures stop early and rates with few failures get more shots.
+     * With a seed and without a time limit the results do not depend on nrThreads.
+     * @param rawDataOutputFilepath if not empty, the estimates are written to this file as json
+     * @param minPhysicalErrRate starting physical error rate
+     * @param maxPhysicalErrRate maximum physical error rate
+     * @param perStepSize stepsize between error rates
+     * @param code
+     * @param decoderType
+     * @param criteria
+     * @param nrThreads number of threads that decode in parallel, 0 uses all hardware threads
+     * @param seed
+     * @return one estimate per physical error rate, the interval is the Wilson score interval of the block error rate divided by k
+     */
+    static std::vector<WerEstimate> simulateWERAdaptive(const std::string&                  rawDataOutputFilepath,
+                                                        double                              minPhysicalErrRate,
+                                                        double                              maxPhysicalErrRate,
+                                                        double                              perStepSize,
+                                                        const Code&                         code,
+                                                        const DecoderType&                  decoderType,
+                                                        const StoppingCriteria&             criteria,
+                                                        std::size_t                         nrThreads = 1U,
+                                                        const std::optional<std::uint64_t>& seed      = std::nullopt);
+
+    /**
+     * Same sweep over physical error rates as simulateWER, but with coupled errors: each shot is sampled once for the
+     * largest rate and the error at a smaller rate is a subset of the error at a larger rate. Going to the next rate only
+     * flips the additional qubits and updates the syndrome by their columns, and shots whose error did not change are not decoded again.
+     * Neighbouring points of the resulting curve are strongly correlated, which makes it smooth.
+     * @param rawDataOutputFilepath if not empty, the estimates are written to this file as json
+     * @param minPhysicalErrRate starting physical error rate
+     * @param maxPhysicalErrRate maximum physical error rate
+     * @param perStepSize stepsize between error rates
+     * @param nrRunsPerRate number of shots, each shot is used at every rate
+     * @param code
+     * @param decoderType
+     * @param nrThreads number of threads that decode in parallel, 0 uses all hardware threads
+     * @param seed
+     * @return one estimate per physical error rate, the interval is the Wilson score interval of the block error rate divided by k
+     */
+    static std::vector<WerEstimate> simulateWERCoupled(const std::string&                  rawDataOutputFilepath,
+                                                       double                              minPhysicalErrRate,
+                                                       double                              maxPhysicalErrRate,
+                                                       double                              perStepSize,
+                                                       std::size_t                         nrRunsPerRate,
+                                                       const Code&                         code,
+                                                       const DecoderType&                  decoderType,
+                                                       std::size_t                         nrThreads = 1U,
+                                                       const std::optional<std::uint64_t>& seed      = std::nullopt);
+
+    /**
+     * Same sweep over physical error rates as simulateWERCoupled, but under phenomenological noise: the syndrome is measured in
+     * the given number of rounds, before each round every data qubit flips with the physical error rate and each measured
+     * check is wrong with the measurement error rate, the last round is perfect. The detection events of all rounds are decoded
+     * on the SpaceTimeGraph of the code and a shot fails if the net data correction does not undo the accumulated error up to a stabilizer.
+     * Decoding graphs have no dense matrix and are only supported by UfHeuristic
+     * @param rawDataOutputFilepath if not empty, the estimates are written to this file as json
+     * @param minPhysicalErrRate starting data error rate
+     * @param maxPhysicalErrRate maximum data error rate
+     * @param perStepSize stepsize between error rates
+     * @param nrRunsPerRate number of shots per rate
+     * @param code
+     * @param decoderType
+     * @param rounds number of syndrome measurement rounds, 1 is the perfect syndrome of simulateWER
+     * @param measurementErrRate if not given, equal to the data error rate of each point
+     * @param nrThreads number of threads that decode in parallel, 0 uses all hardware threads
+     * @param seed if given, the results only depend on the seed and not on nrThreads
+     * @return one estimate per data error rate, the interval is the Wilson score interval of the block error rate divided by k
+     */
+    static std::vector<WerEstimate> simulateWERPhenomenological(const std::string&                  rawDataOutputFilepath,
+                                                                double                              minPhysicalErrRate,
+                                                                double                              maxPhysicalErrRate,
+                                                                double                              perStepSize,
+                                                                std::size_t                         nrRunsPerRate,
+                                                                const Code&                         code,
+                                                                const DecoderType&                  decoderType,
+                                                                std::size_t                         rounds,
+                                                                const std::optional<double>&        measurementErrRate = std::nullopt,
+                                                                std::size_t                         nrThreads          = 1U,
+                                                                const std::optional<std::uint64_t>& seed               = std::nullopt);
+
+    /**
+     * Decodes the same sampled errors with each of the given decoder configurations (common random numbers)
+     * Errors and syndromes are sampled once per shot and shared by all configurations.
+     * Counts are reproducible from the seed for deterministic growth variants, the random growth variants draw their own randomness.
+     * @param rawDataOutputFilepath if not empty, the comparison is written to this file as json
+     * @param physicalErrRate
+     * @param nrShots
+     * @param code
+     * @param configs
+     * @param nrThreads number of threads that decode in parallel, each with one decoder per configuration, 0 uses all hardware threads
+     * @param seed
+     * @return
+     */
+    static DecoderComparison compareDecoders(const std::string&                  rawDataOutputFilepath,
+                                             double                              physicalErrRate,
+                                             std::size_t                         nrShots,
+                                             const Code&                         code,
+                                             const std::vector<DecoderConfig>&   configs,
+                                             std::size_t                         nrThreads = 1U,
+                                             const std::optional<std::uint64_t>& seed      = std::nullopt);
+
+    /**
+     * Estimates the conditional failure rates f(w) for X-errors of each weight w up to maxWeight, from which
+     * WeightStrata::estimate gives the WER at any physical error rate without further decoding.
+     * Weights with at most enumerationLimit errors are decoded exhaustively, the others are sampled uniformly
+     * with shotsPerWeight shots each. The weight 0 stratum is exact without decoding.
+     * @param rawDataOutputFilepath if not empty, the strata and the estimates at physicalErrRates are written to this file as json
+     * @param physicalErrRates rates at which the estimate is written to the output file
+     * @param code
+     * @param decoderType
+     * @param maxWeight largest weight that is sampled, limited to n
+     * @param shotsPerWeight number of shots for each sampled weight
+     * @param enumerationLimit maximum number of errors of a weight to decode exhaustively
+     * @param nrThreads number of threads that decode in parallel, 0 uses all hardware threads
+     * @param seed
+     * @return the strata, indexed by weight
+     */
+    static WeightStrata simulateWERStratified(const std::string&                  rawDataOutputFilepath,
+                                              const std::vector<double>&          physicalErrRates,
+                                              const Code&                         code,
+                                              const DecoderType&                  decoderType,
+                                              std::size_t                         maxWeight,
+                                              std::size_t                         shotsPerWeight,
+                                              std::size_t                         enumerationLimit = 10000U,
+                                              std::size_t                         nrThreads        = 1U,
+                                              const std::optional<std::uint64_t>& seed             = std::nullopt);
+
+    /**
+     * Wilson score interval of a binomial proportion
+     * @param failures number of successes of the binomial, here failed shots
+     * @param shots number of trials
+     * @param z standard normal quantile, 1.96 for 95% confidence
+     * @return lower and upper bound, [0, 1] if there are no shots
      */
-    static void simulateWER(const std::string& rawDataOutputFilepath,
-                            const std::string& statsOutputFilepath,
-                            double             minPhysicalErrRate,
-                            double             maxPhysicalErrRate,
-                            std::size_t        nrRunsPerRate,
-                            Code&              code,
-                            double             perStepSize,
-                            const DecoderType& decoderType); // code is field of decoder
+    static std::pair<double, double> wilsonInterval(std::size_t failures, std::size_t shots, double z);
 
     /**
      * Runs the specified number of decoding runs for each physical error rate on each code and
-     * computes the average runtime (in ms) per code. For this to reflect runtime scaling reasonably
+     * computes the average runtime (in ms, measured in ns so sub-millisecond decodes are not truncated) per code. For this to reflect runtime scaling reasonably
      * the codes should be from the same family (e.g. toric codes) with increasing size.
      * @param rawDataOutputFilepath
      * @param decodingInfoOutfilePath
      * @param physicalErrRates
      * @param nrRuns
      * @param codes
+     * The distribution of the decoding latencies of each code is written to a separate latency file next to the raw data.
+     * Only the decode calls are timed, decoder construction, error sampling and the warm-up shots are not measured
+     * @param nrThreads number of threads that decode in parallel, each with its own decoder, 0 uses all hardware threads
+     * @param seed if given, the sampled errors only depend on the seed and not on nrThreads
+     * @param nrWarmupShots number of shots each decoder decodes before the measurement starts
+     * @return latency histogram per code path
      */
-    static void simulateAverageRuntime(const std::string& rawDataOutputFilepath,
-                                       const std::string& decodingInfoOutfilePath,
-                                       const double&      physicalErrRate,
-                                       std::size_t        nrRuns,
-                                       const std::string& codesPath,
-                                       std::size_t        nrSamples,
-                                       const DecoderType& decoderType);
+    static std::map<std::string, LatencyHistogram> simulateAverageRuntime(const std::string&                  rawDataOutputFilepath,
+                                                                          const std::string&                  decodingInfoOutfilePath,
+                                                                          const double&                       physicalErrRate,
+                                                                          std::size_t                         nrRuns,
+                                                                          const std::string&                  codesPath,
+                                                                          std::size_t                         nrSamples,
+                                                                          const DecoderType&                  decoderType,
+                                                                          std::size_t                         nrThreads     = 1U,
+                                                                          const std::optional<std::uint64_t>& seed          = std::nullopt,
+                                                                          std::size_t                         nrWarmupShots = 100U);
 };
 
 #endif // QECC_DECODINGSIMULATOR_HPP
@@ -0,0 +1,527 @@
+#ifndef QECC_GF2_HPP
+#define QECC_GF2_HPP
+
+#include "QeccException.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using gf2Mat = std::vector<std::vector<bool>>;
+using gf2Vec = std::vector<bool>;
+
+using gf2Word = std::uint64_t;
+
+static constexpr std::size_t GF2_WORD_BITS = 64U;
+
+/**
+ * Number of set bits in a word
+ */
+inline std::size_t gf2Popcount(gf2Word word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_popcountll(word));
+#else
+    word = word - ((word >> 1U) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2U) & 0x3333333333333333ULL);
+    word = (word + (word >> 4U)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<std::size_t>((word * 0x0101010101010101ULL) >> 56U);
+#endif
+}
+
+/**
+ * Index of the lowest set bit, word must not be zero
+ */
+inline std::size_t gf2CountTrailingZeros(gf2Word word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+    std::size_t res = 0U;
+    while ((word & 1U) == 0U) {
+        word >>= 1U;
+        res++;
+    }
+    return res;
+#endif
+}
+
+/**
+ * Bit-packed vector over GF(2), bits are stored in 64-bit words (bit i in word i/64 at position i%64)
+ * Invariant: the unused bits of the last word are zero
+ */
+class Gf2Vector {
+private:
+    std::size_t          nrBits = 0U;
+    std::vector<gf2Word> words{};
+
+public:
+    Gf2Vector() = default;
+
+    explicit Gf2Vector(const std::size_t size) : nrBits(size), words(nrWordsFor(size), 0U) {}
+
+    /**
+     * Conversion shim from the unpacked representation
+     * @param vec
+     */
+    explicit Gf2Vector(const gf2Vec& vec) : Gf2Vector(vec.size()) {
+        for (std::size_t i = 0; i < vec.size(); i++) {
+            if (vec[i]) {
+                set(i);
+            }
+        }
+    }
+
+    static std::size_t nrWordsFor(const std::size_t size) {
+        return (size + GF2_WORD_BITS - 1U) / GF2_WORD_BITS;
+    }
+
+    [[nodiscard]] gf2Vec toBoolVector() const {
+        gf2Vec res(nrBits);
+        forEachSetBit([&res](const std::size_t i) { res[i] = true; });
+        return res;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return nrBits;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return nrBits == 0U;
+    }
+
+    [[nodiscard]] std::size_t nrWords() const {
+        return words.size();
+    }
+
+    [[nodiscard]] gf2Word* data() {
+        return words.data();
+    }
+
+    [[nodiscard]] const gf2Word* data() const {
+        return words.data();
+    }
+
+    [[nodiscard]] bool get(const std::size_t i) const {
+        return ((words[i / GF2_WORD_BITS] >> (i % GF2_WORD_BITS)) & 1U) != 0U;
+    }
+
+    void set(const std::size_t i) {
+        words[i / GF2_WORD_BITS] |= (gf2Word{1U} << (i % GF2_WORD_BITS));
+    }
+
+    void set(const std::size_t i, const bool value) {
+        if (value) {
+            set(i);
+        } else {
+            words[i / GF2_WORD_BITS] &= ~(gf2Word{1U} << (i % GF2_WORD_BITS));
+        }
+    }
+
+    void flip(const std::size_t i) {
+        words[i / GF2_WORD_BITS] ^= (gf2Word{1U} << (i % GF2_WORD_BITS));
+    }
+
+    void clear() {
+        std::fill(words.begin(), words.end(), 0U);
+    }
+
+    Gf2Vector& operator^=(const Gf2Vector& other) {
+        assertSameSize(other);
+        for (std::size_t w = 0; w < words.size(); w++) {
+            words[w] ^= other.words[w];
+        }
+        return *this;
+    }
+
+    Gf2Vector& operator&=(const Gf2Vector& other) {
+        assertSameSize(other);
+        for (std::size_t w = 0; w < words.size(); w++) {
+            words[w] &= other.words[w];
+        }
+        return *this;
+    }
+
+    Gf2Vector& operator|=(const Gf2Vector& other) {
+        assertSameSize(other);
+        for (std::size_t w = 0; w < words.size(); w++) {
+            words[w] |= other.words[w];
+        }
+        return *this;
+    }
+
+    bool operator==(const Gf2Vector& other) const {
+        return nrBits == other.nrBits && words == other.words;
+    }
+
+    bool operator!=(const Gf2Vector& other) const {
+        return !(*this == other);
+    }
+
+    /**
+     * Hamming weight of the vector
+     */
+    [[nodiscard]] std::size_t popcount() const {
+        std::size_t res = 0U;
+        for (const auto w : words) {
+            res += gf2Popcount(w);
+        }
+        return res;
+    }
+
+    [[nodiscard]] bool any() const {
+        return std::any_of(words.begin(), words.end(), [](const gf2Word w) { return w != 0U; });
+    }
+
+    [[nodiscard]] bool none() const {
+        return !any();
+    }
+
+    /**
+     * Inner product over GF(2), i.e., parity of the bitwise and
+     * @param other
+     * @return
+     */
+    [[nodiscard]] bool dot(const Gf2Vector& other) const {
+        assertSameSize(other);
+        gf2Word acc = 0U;
+        for (std::size_t w = 0; w < words.size(); w++) {
+            acc ^= words[w] & other.words[w];
+        }
+        return (gf2Popcount(acc) & 1U) != 0U;
+    }
+
+    /**
+     * Calls f(i) for every index i whose bit is set, in increasing order
+     */
+    template <class F>
+    void forEachSetBit(F&& f) const {
+        for (std::size_t w = 0; w < words.size(); w++) {
+            auto word = words[w];
+            while (word != 0U) {
+                f(w * GF2_WORD_BITS + gf2CountTrailingZeros(word));
+                word &= word - 1U;
+            }
+        }
+    }
+
+    /**
+     * Returns the indices of the set bits (the support of the vector)
+     */
+    [[nodiscard]] std::vector<std::size_t> supportIndices() const {
+        std::vector<std::size_t> res;
+        forEachSetBit([&res](const std::size_t i) { res.emplace_back(i); });
+        return res;
+    }
+
+private:
+    void assertSameSize(const Gf2Vector& other) const {
+        if (nrBits != other.nrBits) {
+            throw QeccException("Gf2Vector dimensions do not match");
+        }
+    }
+};
+
+/**
+ * Bit-packed matrix over GF(2). Rows are stored contiguously and each row starts at a word boundary
+ */
+class Gf2Matrix {
+private:
+    std::size_t          nrRows = 0U;
+    std::size_t          nrCols = 0U;
+    std::size_t          stride = 0U; // words per row
+    std::vector<gf2Word> words{};
+
+public:
+    Gf2Matrix() = default;
+
+    Gf2Matrix(const std::size_t rows, const std::size_t cols) : nrRows(rows), nrCols(cols), stride(Gf2Vector::nrWordsFor(cols)), words(rows * stride, 0U) {}
+
+    /**
+     * Conversion shim from the unpacked representation, all rows are assumed to have the same length
+     * @param mat
+     */
+    explicit Gf2Matrix(const gf2Mat& mat) : Gf2Matrix(mat.size(), mat.empty() ? 0U : mat.front().size()) {
+        for (std::size_t i = 0; i < nrRows; i++) {
+            if (mat[i].size() != nrCols) {
+                throw QeccException("Cannot convert matrix, rows differ in length");
+            }
+            for (std::size_t j = 0; j < nrCols; j++) {
+                if (mat[i][j]) {
+                    set(i, j);
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] gf2Mat toBoolMatrix() const {
+        gf2Mat res(nrRows);
+        for (std::size_t i = 0; i < nrRows; i++) {
+            res[i] = row(i).toBoolVector();
+        }
+        return res;
+    }
+
+    [[nodiscard]] std::size_t rows() const {
+        return nrRows;
+    }
+
+    [[nodiscard]] std::size_t cols() const {
+        return nrCols;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return nrRows == 0U || nrCols == 0U;
+    }
+
+    [[nodiscard]] std::size_t rowStride() const {
+        return stride;
+    }
+
+    [[nodiscard]] gf2Word* rowData(const std::size_t r) {
+        return words.data() + r * stride;
+    }
+
+    [[nodiscard]] const gf2Word* rowData(const std::size_t r) const {
+        return words.data() + r * stride;
+    }
+
+    [[nodiscard]] bool get(const std::size_t r, const std::size_t c) const {
+        return ((rowData(r)[c / GF2_WORD_BITS] >> (c % GF2_WORD_BITS)) & 1U) != 0U;
+    }
+
+    void set(const std::size_t r, const std::size_t c) {
+        rowData(r)[c / GF2_WORD_BITS] |= (gf2Word{1U} << (c % GF2_WORD_BITS));
+    }
+
+    void set(const std::size_t r, const std::size_t c, const bool value) {
+        if (value) {
+            set(r, c);
+        } else {
+            rowData(r)[c / GF2_WORD_BITS] &= ~(gf2Word{1U} << (c % GF2_WORD_BITS));
+        }
+    }
+
+    void flip(const std::size_t r, const std::size_t c) {
+        rowData(r)[c / GF2_WORD_BITS] ^= (gf2Word{1U} << (c % GF2_WORD_BITS));
+    }
+
+    /**
+     * Returns a copy of row r
+     */
+    [[nodiscard]] Gf2Vector row(const std::size_t r) const {
+        Gf2Vector res(nrCols);
+        std::copy(rowData(r), rowData(r) + stride, res.data());
+        return res;
+    }
+
+    /**
+     * Overwrites row r with the given vector
+     */
+    void setRow(const std::size_t r, const Gf2Vector& vec) {
+        if (vec.size() != nrCols) {
+            throw QeccException("Cannot set row, dimensions do not match");
+        }
+        std::copy(vec.data(), vec.data() + stride, rowData(r));
+    }
+
+    /**
+     * Overwrites row dst with row src of another matrix with the same number of columns
+     */
+    void copyRowFrom(const std::size_t dst, const Gf2Matrix& other, const std::size_t src) {
+        if (other.nrCols != nrCols) {
+            throw QeccException("Cannot copy row, dimensions do not match");
+        }
+        std::copy(other.rowData(src), other.rowData(src) + stride, rowData(dst));
+    }
+
+    /**
+     * Row operation dst = dst + src
+     */
+    void addRow(const std::size_t src, const std::size_t dst) {
+        const auto* s = rowData(src);
+        auto*       d = rowData(dst);
+        for (std::size_t w = 0; w < stride; w++) {
+            d[w] ^= s[w];
+        }
+    }
+
+    void swapRows(const std::size_t r1, const std::size_t r2) {
+        if (r1 != r2) {
+            std::swap_ranges(rowData(r1), rowData(r1) + stride, rowData(r2));
+        }
+    }
+
+    /**
+     * Inner product of row r and the given vector over GF(2)
+     */
+    [[nodiscard]] bool rowDot(const std::size_t r, const Gf2Vector& vec) const {
+        const auto* rw  = rowData(r);
+        const auto* vw  = vec.data();
+        gf2Word     acc = 0U;
+        for (std::size_t w = 0; w < stride; w++) {
+            acc ^= rw[w] & vw[w];
+        }
+        return (gf2Popcount(acc) & 1U) != 0U;
+    }
+
+    [[nodiscard]] bool isZeroRow(const std::size_t r) const {
+        return std::all_of(rowData(r), rowData(r) + stride, [](const gf2Word w) { return w == 0U; });
+    }
+
+    /**
+     * Number of non-zero entries in the matrix
+     */
+    [[nodiscard]] std::size_t popcount() const {
+        std::size_t res = 0U;
+        for (const auto w : words) {
+            res += gf2Popcount(w);
+        }
+        return res;
+    }
+
+    [[nodiscard]] Gf2Matrix transpose() const {
+        Gf2Matrix res(nrCols, nrRows);
+        for (std::size_t r = 0; r < nrRows; r++) {
+            const auto* rw = rowData(r);
+            for (std::size_t w = 0; w < stride; w++) {
+                auto word = rw[w];
+                while (word != 0U) {
+                    res.set(w * GF2_WORD_BITS + gf2CountTrailingZeros(word), r);
+                    word &= word - 1U;
+                }
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Brings the matrix into reduced row echelon form using word-parallel row operations
+     * If rhs is given, the same row operations are applied to it, which turns Mx=b into an equivalent reduced system
+     * @param rhs optional right hand side with one bit per row
+     * @return the pivot column of each non-zero row, these rows are the first pivots.size() rows of the result
+     */
+    std::vector<std::size_t> rref(Gf2Vector* rhs = nullptr) {
+        if (rhs != nullptr && rhs->size() != nrRows) {
+            throw QeccException("Right hand side does not match number of rows");
+        }
+        std::vector<std::size_t> pivots;
+        for (std::size_t c = 0; c < nrCols && pivots.size() < nrRows; c++) {
+            const auto    rank = pivots.size();
+            const auto    w    = c / GF2_WORD_BITS;
+            const gf2Word mask = gf2Word{1U} << (c % GF2_WORD_BITS);
+            auto          r    = rank;
+            while (r < nrRows && (rowData(r)[w] & mask) == 0U) {
+                r++;
+            }
+            if (r == nrRows) {
+                continue;
+            }
+            swapRows(r, rank);
+            const bool rhsPivot = rhs != nullptr && rhs->get(r);
+            if (rhs != nullptr && rhsPivot != rhs->get(rank)) {
+                rhs->flip(r);
+                rhs->flip(rank);
+            }
+            // the pivot row is zero left of column c, so only the words from w onwards need to be added
+            const auto* pivotRow = rowData(rank);
+            for (std::size_t i = 0; i < nrRows; i++) {
+                auto* row = rowData(i);
+                if (i != rank && (row[w] & mask) != 0U) {
+                    for (auto k = w; k < stride; k++) {
+                        row[k] ^= pivotRow[k];
+                    }
+                    if (rhsPivot) {
+                        rhs->flip(i);
+                    }
+                }
+            }
+            pivots.emplace_back(c);
+        }
+        return pivots;
+    }
+
+    [[nodiscard]] std::size_t rank() const {
+        auto reduced = *this;
+        return reduced.rref().size();
+    }
+
+    /**
+     * Solves Mx=b by reducing the matrix together with b
+     * If there are multiple solutions, the one with all free variables set to zero is returned
+     * @param b
+     * @return a solution x, or an empty vector if the system is inconsistent
+     */
+    [[nodiscard]] Gf2Vector solve(const Gf2Vector& b) const {
+        auto       reduced = *this;
+        auto       rhs     = b;
+        const auto pivots  = reduced.rref(&rhs);
+        for (auto i = pivots.size(); i < nrRows; i++) {
+            if (rhs.get(i)) {
+                return Gf2Vector{};
+            }
+        }
+        Gf2Vector x(nrCols);
+        for (std::size_t i = 0; i < pivots.size(); i++) {
+            if (rhs.get(i)) {
+                x.set(pivots[i]);
+            }
+        }
+        return x;
+    }
+
+    /**
+     * Checks if vec is a linear combination of the rows of the matrix
+     */
+    [[nodiscard]] bool isInRowspace(const Gf2Vector& vec) const {
+        if (vec.size() != nrCols) {
+            throw QeccException("Cannot check if in rowspace, dimensions of matrix and vector do not match");
+        }
+        if (vec.none()) {
+            return true;
+        }
+        auto       reduced = *this;
+        const auto pivots  = reduced.rref();
+        auto       rem     = vec;
+        for (std::size_t i = 0; i < pivots.size(); i++) {
+            if (rem.get(pivots[i])) {
+                rem ^= reduced.row(i);
+            }
+        }
+        return rem.none();
+    }
+
+    /**
+     * Computes a basis of the right kernel {x : Mx = 0}, one basis vector per row of the result
+     */
+    [[nodiscard]] Gf2Matrix nullspace() const {
+        auto              reduced = *this;
+        const auto        pivots  = reduced.rref();
+        std::vector<bool> isPivot(nrCols);
+        for (const auto p : pivots) {
+            isPivot[p] = true;
+        }
+        Gf2Matrix   res(nrCols - pivots.size(), nrCols);
+        std::size_t k = 0U;
+        for (std::size_t f = 0; f < nrCols; f++) {
+            if (isPivot[f]) {
+                continue;
+            }
+            res.set(k, f);
+            for (std::size_t i = 0; i < pivots.size(); i++) {
+                if (reduced.get(i, f)) {
+                    res.set(k, pivots[i]);
+                }
+            }
+            k++;
+        }
+        return res;
+    }
+
+    bool operator==(const Gf2Matrix& other) const {
+        return nrRows == other.nrRows && nrCols == other.nrCols && words == other.words;
+    }
+
+    bool operator!=(const Gf2Matrix& other) const {
+        return !(*this == other);
+    }
+};
+#endif // QECC_GF2_HPP
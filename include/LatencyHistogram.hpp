@@ -0,0 +1,151 @@
+#ifndef QECC_LATENCYHISTOGRAM_HPP
+#define QECC_LATENCYHISTOGRAM_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using json = nlohmann::json;
+
+/**
+ * Log-bucketed histogram of latencies in ns (in the style of HdrHistogram)
+ * Values below 2^SUB_BUCKET_BITS are counted exactly, larger values in buckets of relative width 2^(1 - SUB_BUCKET_BITS),
+ * so the whole uint64 range fits into a few thousand counters and percentiles are accurate to below 2%.
+ * Histograms have a fixed layout and can be filled per thread and merged by adding the counters
+ */
+class LatencyHistogram {
+public:
+    static constexpr std::size_t SUB_BUCKET_BITS = 7U;
+    static constexpr std::size_t HALF_SUB_COUNT  = std::size_t{1U} << (SUB_BUCKET_BITS - 1);
+    static constexpr std::size_t NR_BUCKETS      = (66U - SUB_BUCKET_BITS) * HALF_SUB_COUNT;
+
+    LatencyHistogram() : counts(NR_BUCKETS) {}
+
+    void record(const std::uint64_t nanos) {
+        counts[bucketIndex(nanos)]++;
+        nrValues++;
+        sum += static_cast<double>(nanos);
+        minValue = std::min(minValue, nanos);
+        maxValue = std::max(maxValue, nanos);
+    }
+
+    LatencyHistogram& operator+=(const LatencyHistogram& other) {
+        for (std::size_t i = 0; i < NR_BUCKETS; i++) {
+            counts[i] += other.counts[i];
+        }
+        nrValues += other.nrValues;
+        sum += other.sum;
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+        return *this;
+    }
+
+    [[nodiscard]] std::uint64_t count() const {
+        return nrValues;
+    }
+    [[nodiscard]] std::uint64_t min() const {
+        return nrValues == 0U ? 0U : minValue;
+    }
+    [[nodiscard]] std::uint64_t max() const {
+        return maxValue;
+    }
+    [[nodiscard]] double mean() const {
+        return nrValues == 0U ? 0.0 : sum / static_cast<double>(nrValues);
+    }
+
+    /**
+     * Smallest recorded latency such that at least the given percentage of values is not larger, up to the bucket resolution
+     * @param percentile in [0, 100]
+     */
+    [[nodiscard]] std::uint64_t valueAtPercentile(const double percentile) const {
+        if (nrValues == 0U) {
+            return 0U;
+        }
+        const auto    clamped = std::clamp(percentile, 0.0, 100.0);
+        const auto    rank    = std::max<std::uint64_t>(1U, static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(nrValues))));
+        std::uint64_t seen    = 0U;
+        for (std::size_t i = 0; i < NR_BUCKETS; i++) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return std::clamp(bucketUpper(i), min(), maxValue);
+            }
+        }
+        return maxValue;
+    }
+
+    /**
+     * Non-empty buckets as (lowest value, highest value, count)
+     */
+    [[nodiscard]] std::vector<std::tuple<std::uint64_t, std::uint64_t, std::uint64_t>> buckets() const {
+        std::vector<std::tuple<std::uint64_t, std::uint64_t, std::uint64_t>> res;
+        for (std::size_t i = 0; i < NR_BUCKETS; i++) {
+            if (counts[i] != 0U) {
+                res.emplace_back(bucketLower(i), bucketUpper(i), counts[i]);
+            }
+        }
+        return res;
+    }
+
+    static std::size_t bucketIndex(const std::uint64_t value) {
+        if (value < 2 * HALF_SUB_COUNT) {
+            return static_cast<std::size_t>(value);
+        }
+        // keep the SUB_BUCKET_BITS leading bits of the value
+        const auto shift = highestBit(value) - SUB_BUCKET_BITS + 1;
+        return (shift + 1) * HALF_SUB_COUNT + static_cast<std::size_t>(value >> shift) - HALF_SUB_COUNT;
+    }
+    static std::uint64_t bucketLower(const std::size_t idx) {
+        if (idx < 2 * HALF_SUB_COUNT) {
+            return idx;
+        }
+        const auto shift = idx / HALF_SUB_COUNT - 1;
+        return static_cast<std::uint64_t>(idx % HALF_SUB_COUNT + HALF_SUB_COUNT) << shift;
+    }
+    static std::uint64_t bucketUpper(const std::size_t idx) {
+        if (idx < 2 * HALF_SUB_COUNT) {
+            return idx;
+        }
+        const auto shift = idx / HALF_SUB_COUNT - 1;
+        return bucketLower(idx) + ((std::uint64_t{1U} << shift) - 1);
+    }
+
+    [[nodiscard]] json to_json() const { // NOLINT(readability-identifier-naming)
+        return json{{"count", count()},
+                    {"min(ns)", min()},
+                    {"max(ns)", max()},
+                    {"mean(ns)", mean()},
+                    {"p50(ns)", valueAtPercentile(50.0)},
+                    {"p90(ns)", valueAtPercentile(90.0)},
+                    {"p99(ns)", valueAtPercentile(99.0)},
+                    {"p99.9(ns)", valueAtPercentile(99.9)},
+                    {"buckets", buckets()}};
+    }
+    [[nodiscard]] std::string toString() const {
+        return this->to_json().dump(2U);
+    }
+
+private:
+    static std::size_t highestBit(const std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63U - static_cast<std::size_t>(__builtin_clzll(value));
+#else
+        std::size_t res = 0U;
+        for (auto v = value; v > 1U; v >>= 1U) {
+            res++;
+        }
+        return res;
+#endif
+    }
+
+    std::vector<std::uint64_t> counts;
+    std::uint64_t              nrValues = 0U;
+    double                     sum      = 0.0;
+    std::uint64_t              minValue = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t              maxValue = 0U;
+};
+#endif // QECC_LATENCYHISTOGRAM_HPP
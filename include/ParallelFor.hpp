@@ -0,0 +1,66 @@
+#ifndef QECC_PARALLELFOR_HPP
+#define QECC_PARALLELFOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Number of worker threads, 0 for all hardware threads
+ */
+inline std::size_t resolveNrThreads(const std::size_t nrThreads) {
+    if (nrThreads != 0U) {
+        return nrThreads;
+    }
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+/**
+ * Runs f(task, worker) for all tasks in [0, nrTasks) on up to nrWorkers threads
+ * Tasks are handed out dynamically, results must therefore only depend on the task index and not on the worker
+ * The first exception thrown by a task stops the remaining tasks and is rethrown to the caller
+ */
+template <class F>
+void parallelFor(const std::size_t nrTasks, const std::size_t nrWorkers, F&& f) {
+    const auto nrThreads = std::min(nrWorkers, nrTasks);
+    if (nrThreads <= 1U) {
+        for (std::size_t task = 0; task < nrTasks; task++) {
+            f(task, 0U);
+        }
+        return;
+    }
+    std::atomic<std::size_t> nextTask{0U};
+    std::atomic<bool>        failed{false};
+    std::exception_ptr       error;
+    std::mutex               errorMutex;
+
+    const auto work = [&](const std::size_t worker) {
+        try {
+            for (auto task = nextTask++; task < nrTasks && !failed; task = nextTask++) {
+                f(task, worker);
+            }
+        } catch (...) {
+            const std::lock_guard<std::mutex> lock(errorMutex);
+            if (!failed.exchange(true)) {
+                error = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(nrThreads - 1);
+    for (std::size_t worker = 1; worker < nrThreads; worker++) {
+        threads.emplace_back(work, worker);
+    }
+    work(0U);
+    for (auto& t : threads) {
+        t.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+#endif // QECC_PARALLELFOR_HPP
@@ -0,0 +1,96 @@
+#ifndef QECC_PHASETIMER_HPP
+#define QECC_PHASETIMER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+/**
+ * Per-phase timings are only recorded if the library is built with QECC_PHASE_TIMING (cmake option MQT_QECC_PHASE_TIMING),
+ * otherwise the stopwatch compiles to nothing and all phase times stay 0
+ */
+#ifdef QECC_PHASE_TIMING
+inline constexpr bool PHASE_TIMING_ENABLED = true;
+#else
+inline constexpr bool PHASE_TIMING_ENABLED = false;
+#endif
+
+enum class DecodingPhase : std::size_t {
+    Lookup,         // probing the table of low-weight syndromes
+    Setup,          // resetting workspaces and initial clusters
+    Growth,         // growing cluster boundaries
+    Fusion,         // merging clusters that grew together
+    BoundaryUpdate, // removing vertices that left the boundary
+    ValidityCheck,  // deciding which clusters are valid
+    Solve,          // erasure decoding or Gaussian elimination on the final clusters
+    Output,         // building the estimate
+    NrPhases
+};
+
+struct PhaseTimings {
+    static constexpr std::size_t NR_PHASES = static_cast<std::size_t>(DecodingPhase::NrPhases);
+
+    std::array<std::uint64_t, NR_PHASES> nanos{};
+
+    [[nodiscard]] std::uint64_t& operator[](const DecodingPhase phase) {
+        return nanos[static_cast<std::size_t>(phase)]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    }
+    [[nodiscard]] std::uint64_t operator[](const DecodingPhase phase) const {
+        return nanos[static_cast<std::size_t>(phase)]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    }
+
+    PhaseTimings& operator+=(const PhaseTimings& other) {
+        for (std::size_t i = 0; i < NR_PHASES; i++) {
+            nanos[i] += other.nanos[i]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        }
+        return *this;
+    }
+
+    [[nodiscard]] std::uint64_t total() const {
+        std::uint64_t res = 0U;
+        for (const auto t : nanos) {
+            res += t;
+        }
+        return res;
+    }
+
+    [[nodiscard]] json to_json() const { // NOLINT(readability-identifier-naming)
+        return json{{"lookup", (*this)[DecodingPhase::Lookup]},
+                    {"setup", (*this)[DecodingPhase::Setup]},
+                    {"growth", (*this)[DecodingPhase::Growth]},
+                    {"fusion", (*this)[DecodingPhase::Fusion]},
+                    {"boundaryUpdate", (*this)[DecodingPhase::BoundaryUpdate]},
+                    {"validityCheck", (*this)[DecodingPhase::ValidityCheck]},
+                    {"solve", (*this)[DecodingPhase::Solve]},
+                    {"output", (*this)[DecodingPhase::Output]}};
+    }
+};
+
+/**
+ * Attributes the time since the previous lap (or construction) to the given phase
+ * Laps are placed at the end of each phase, so consecutive phases need a single clock read
+ */
+class PhaseStopwatch {
+public:
+    explicit PhaseStopwatch(PhaseTimings& t) : timings(t) {
+        if constexpr (PHASE_TIMING_ENABLED) {
+            last = std::chrono::steady_clock::now();
+        }
+    }
+
+    void lap([[maybe_unused]] const DecodingPhase phase) {
+        if constexpr (PHASE_TIMING_ENABLED) {
+            const auto now = std::chrono::steady_clock::now();
+            timings[phase] += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count());
+            last = now;
+        }
+    }
+
+private:
+    PhaseTimings&                         timings;
+    std::chrono::steady_clock::time_point last{};
+};
+#endif // QECC_PHASETIMER_HPP
@@ -0,0 +1,59 @@
+#ifndef QECC_RANDOMSTREAM_HPP
+#define QECC_RANDOMSTREAM_HPP
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * Small random bit generator (xoshiro256**) whose state is derived from a seed and a stream index
+ * Stream i of a given seed is the same no matter which thread draws from it or in which order streams are created,
+ * so Monte Carlo tasks indexed by i reproduce their samples independent of how they are scheduled
+ * Satisfies UniformRandomBitGenerator and can be used with the distributions of <random>
+ */
+class RandomStream {
+public:
+    using result_type = std::uint64_t; // NOLINT(readability-identifier-naming)
+
+    RandomStream(const std::uint64_t seed, const std::uint64_t stream) {
+        // splitmix64 spreads (seed, stream) over the whole state so that neighbouring streams are uncorrelated
+        auto x = seed ^ splitmix(stream + GOLDEN_GAMMA);
+        for (auto& s : state) {
+            x += GOLDEN_GAMMA;
+            s = splitmix(x);
+        }
+    }
+
+    static constexpr result_type min() {
+        return std::numeric_limits<result_type>::min();
+    }
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() {
+        const auto res = rotl(state[1] * 5U, 7) * 9U;
+        const auto t   = state[1] << 17U;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return res;
+    }
+
+private:
+    static constexpr std::uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+    static constexpr std::uint64_t splitmix(std::uint64_t z) {
+        z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31U);
+    }
+    static constexpr std::uint64_t rotl(const std::uint64_t x, const int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t state[4]{}; // NOLINT(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+};
+#endif // QECC_RANDOMSTREAM_HPP
@@ -0,0 +1,300 @@
+#ifndef QECC_RESULTSSINK_HPP
+#define QECC_RESULTSSINK_HPP
+
+#include "BoundedQueue.hpp"
+#include "DecodingRunInformation.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Outcome of a single simulated shot, vectors are stored sparsely as lists of set indices
+ */
+struct ShotRecord {
+    double                     physicalErrRate = 0.0;
+    std::uint64_t              shot            = 0U;
+    DecodingResultStatus       status          = SUCCESS;
+    std::uint32_t              codeId          = 0U; // distinguishes codes if records of several codes are stored together
+    std::size_t                decodingTime    = 0U; // in ms
+    std::uint64_t              decodingNanos   = 0U; // wall time of the decode call
+    std::vector<std::uint32_t> error{};              // flipped qubits
+    std::vector<std::uint32_t> syndrome{};           // violated checks
+    std::vector<std::uint32_t> estimate{};           // qubits flipped by the decoder
+
+    /**
+     * Appends the record as a single line of json to out, e.g.
+     * {"physicalErrRate":0.01,"shot":3,"code":0,"status":"failure","decodingTime(ms)":0,"decodingTime(ns)":5310,"error":[4,17],"syndrome":[2,5,9],"estimate":[4]}
+     */
+    void appendNdjson(std::string& out) const {
+        out += R"({"physicalErrRate":)";
+        appendDouble(out, physicalErrRate);
+        out += R"(,"shot":)";
+        out += std::to_string(shot);
+        out += R"(,"code":)";
+        out += std::to_string(codeId);
+        out += status == SUCCESS ? R"(,"status":"success")" : R"(,"status":"failure")";
+        out += ",\"decodingTime(ms)\":";
+        out += std::to_string(decodingTime);
+        out += ",\"decodingTime(ns)\":";
+        out += std::to_string(decodingNanos);
+        appendIndices(out, R"(,"error":[)", error);
+        appendIndices(out, R"(,"syndrome":[)", syndrome);
+        appendIndices(out, R"(,"estimate":[)", estimate);
+        out += "}\n";
+    }
+
+private:
+    /**
+     * 17 significant digits read back to the same double, std::to_string would round small rates to 0.000000
+     */
+    static void appendDouble(std::string& out, const double value) {
+        std::array<char, 32> buf{};
+        const auto           len = std::snprintf(buf.data(), buf.size(), "%.17g", value);
+        out.append(buf.data(), static_cast<std::size_t>(len));
+    }
+    static void appendIndices(std::string& out, const char* key, const std::vector<std::uint32_t>& indices) {
+        out += key;
+        for (std::size_t i = 0; i < indices.size(); i++) {
+            if (i != 0U) {
+                out += ',';
+            }
+            out += std::to_string(indices[i]);
+        }
+        out += ']';
+    }
+};
+
+/**
+ * Destination of the per shot records of a simulation
+ * write may be called concurrently from the decoding threads
+ */
+class ResultsSink {
+public:
+    ResultsSink()                              = default;
+    ResultsSink(const ResultsSink&)            = delete;
+    ResultsSink& operator=(const ResultsSink&) = delete;
+    virtual ~ResultsSink()                     = default;
+
+    virtual void write(ShotRecord&& record) = 0;
+    /**
+     * Blocks until all records written so far have been stored, no records may be written afterwards
+     */
+    virtual void close() {}
+};
+
+/**
+ * Encodes records as newline delimited json, one line per record
+ */
+class NdjsonWriter {
+public:
+    explicit NdjsonWriter(const std::string& filepath) : out(filepath) {
+        if (!out) {
+            throw QeccException("Cannot open results file");
+        }
+    }
+
+    void store(const ShotRecord& record) {
+        record.appendNdjson(buffer);
+        if (buffer.size() >= FLUSH_BYTES) {
+            flushBuffer();
+        }
+    }
+
+    void finish() {
+        flushBuffer();
+        out.close();
+    }
+
+private:
+    static constexpr std::size_t FLUSH_BYTES = 1U << 16U;
+
+    void flushBuffer() {
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    std::ofstream out;
+    std::string   buffer;
+};
+
+/**
+ * Append-only binary columnar encoding, readable without parsing by mqt.qecc.load_results
+ * The records are stored in a directory with one file per column, each a little-endian array:
+ *   p.f64, code.u32, status.u8 (0 success, 1 failure), latency_ns.u64   one entry per record
+ *   syndrome_offsets.u64, estimate_offsets.u64                          one entry per record after a leading 0
+ *   syndrome_indices.u32, estimate_indices.u32                          concatenated sparse index lists
+ * The indices of record i are [offsets[i], offsets[i+1]) of the respective indices column.
+ * meta.json holds the format version and the number of records once the writer is finished,
+ * if it is missing the number of records is given by the size of p.f64
+ */
+class ColumnarWriter {
+public:
+    static constexpr std::uint32_t VERSION = 1U;
+
+    explicit ColumnarWriter(const std::string& directory) : dir(directory) {
+        std::filesystem::create_directories(dir);
+        for (std::size_t c = 0; c < NR_COLUMNS; c++) {
+            columns[c].open(dir / COLUMN_FILES[c], std::ios::binary | std::ios::trunc);
+            if (!columns[c]) {
+                throw QeccException("Cannot open results column");
+            }
+        }
+        // leading offsets
+        append(SYNDROME_OFFSETS, std::uint64_t{0U});
+        append(ESTIMATE_OFFSETS, std::uint64_t{0U});
+    }
+
+    void store(const ShotRecord& record) {
+        append(P, record.physicalErrRate);
+        append(CODE, record.codeId);
+        append(STATUS, static_cast<std::uint8_t>(record.status == SUCCESS ? 0U : 1U));
+        append(LATENCY, record.decodingNanos);
+        appendIndices(SYNDROME_OFFSETS, SYNDROME_INDICES, syndromeEnd, record.syndrome);
+        appendIndices(ESTIMATE_OFFSETS, ESTIMATE_INDICES, estimateEnd, record.estimate);
+        nrRecords++;
+        if (pending >= FLUSH_BYTES) {
+            for (std::size_t c = 0; c < NR_COLUMNS; c++) {
+                flushColumn(c);
+            }
+        }
+    }
+
+    void finish() {
+        for (std::size_t c = 0; c < NR_COLUMNS; c++) {
+            flushColumn(c);
+            columns[c].close();
+        }
+        std::ofstream meta(dir / "meta.json");
+        meta << json{{"format", "mqt-qecc-columnar"}, {"version", VERSION}, {"records", nrRecords}}.dump();
+    }
+
+private:
+    enum Column : std::size_t {
+        P,
+        CODE,
+        STATUS,
+        LATENCY,
+        SYNDROME_OFFSETS,
+        SYNDROME_INDICES,
+        ESTIMATE_OFFSETS,
+        ESTIMATE_INDICES,
+        NR_COLUMNS
+    };
+    static constexpr std::array<const char*, NR_COLUMNS> COLUMN_FILES = {"p.f64", "code.u32", "status.u8", "latency_ns.u64",
+                                                                         "syndrome_offsets.u64", "syndrome_indices.u32", "estimate_offsets.u64", "estimate_indices.u32"};
+    static constexpr std::size_t FLUSH_BYTES = 1U << 18U;
+
+    template <class T>
+    void append(const Column c, const T value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        // the format is little-endian, which is the native byte order on all supported platforms
+        const auto* bytes = reinterpret_cast<const char*>(&value); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        buffers[c].insert(buffers[c].end(), bytes, bytes + sizeof(T)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        pending += sizeof(T);
+    }
+
+    void appendIndices(const Column offsets, const Column indices, std::uint64_t& end, const std::vector<std::uint32_t>& values) {
+        for (const auto v : values) {
+            append(indices, v);
+        }
+        end += values.size();
+        append(offsets, end);
+    }
+
+    void flushColumn(const std::size_t c) {
+        auto& buffer = buffers[c];
+        columns[c].write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        pending -= buffer.size();
+        buffer.clear();
+    }
+
+    std::filesystem::path                     dir;
+    std::array<std::ofstream, NR_COLUMNS>     columns;
+    std::array<std::vector<char>, NR_COLUMNS> buffers;
+    std::size_t                               pending     = 0U; // bytes buffered over all columns
+    std::uint64_t                             syndromeEnd = 0U;
+    std::uint64_t                             estimateEnd = 0U;
+    std::uint64_t                             nrRecords   = 0U;
+};
+
+/**
+ * Stores records on a background thread with the given writer (NdjsonWriter or ColumnarWriter)
+ * Decoding threads only move their records into a bounded lock-free queue, encoding and I/O happen on the writer thread.
+ * If the queue is full, write waits for the writer to catch up, so memory stays bounded
+ */
+template <class Writer>
+class AsyncSink : public ResultsSink {
+public:
+    explicit AsyncSink(const std::string& filepath, const std::size_t queueCapacity = DEFAULT_CAPACITY) : queue(queueCapacity), encoder(filepath) {
+        writer = std::thread([this] { run(); });
+    }
+    ~AsyncSink() override {
+        close();
+    }
+    AsyncSink(const AsyncSink&)            = delete;
+    AsyncSink& operator=(const AsyncSink&) = delete;
+
+    void write(ShotRecord&& record) override {
+        while (!queue.tryPush(record)) {
+            std::this_thread::yield();
+        }
+    }
+
+    void close() override {
+        if (writer.joinable()) {
+            closing.store(true, std::memory_order_release);
+            writer.join();
+        }
+    }
+
+    /**
+     * Number of records stored so far, exact after close
+     */
+    [[nodiscard]] std::size_t nrWritten() const {
+        return written.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr std::size_t DEFAULT_CAPACITY = 1U << 14U;
+
+    void run() {
+        ShotRecord record;
+        while (true) {
+            if (queue.tryPop(record)) {
+                encoder.store(record);
+                written.fetch_add(1U, std::memory_order_relaxed);
+                continue;
+            }
+            // records pushed before close are visible once closing is, so an empty queue after that means we are done
+            if (closing.load(std::memory_order_acquire)) {
+                if (queue.tryPop(record)) {
+                    encoder.store(record);
+                    written.fetch_add(1U, std::memory_order_relaxed);
+                    continue;
+                }
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        encoder.finish();
+    }
+
+    BoundedQueue<ShotRecord> queue;
+    Writer                   encoder;
+    std::atomic<bool>        closing{false};
+    std::atomic<std::size_t> written{0U};
+    std::thread              writer; // started in the constructor body, once the members it uses are initialized
+};
+
+using AsyncNdjsonSink   = AsyncSink<NdjsonWriter>;
+using AsyncColumnarSink = AsyncSink<ColumnarWriter>;
+#endif // QECC_RESULTSSINK_HPP
@@ -0,0 +1,107 @@
+#ifndef QECC_SLIDINGWINDOWDECODER_HPP
+#define QECC_SLIDINGWINDOWDECODER_HPP
+
+#include "Code.hpp"
+#include "Decoder.hpp"
+#include "LatencyHistogram.hpp"
+#include "SpaceTimeGraph.hpp"
+#include "UFHeuristic.hpp"
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/**
+ * Streaming decoder of repeated noisy syndrome measurements with a sliding window
+ * Syndromes are pushed one round at a time. Once W rounds are buffered, they are decoded on the space-time graph of W rounds,
+ * whose last round is open to measurement errors since the following rounds are not known yet. The corrections of the oldest
+ * C rounds are committed and their rounds are dropped, the other W-C rounds stay buffered and are decoded again in the next
+ * window together with the new rounds. A committed wrong measurement in the last committed round also explains a detector of
+ * the next round, this detector is flipped before the next window is decoded.
+ * Memory and decoding time per window only depend on W, not on the length of the experiment.
+ * The stream ends with a perfect syndrome, e.g. from a readout of the data qubits, which commits all buffered rounds
+ */
+class SlidingWindowDecoder {
+public:
+    /**
+     * @param c code whose syndromes are measured, decoded with hZ
+     * @param window rounds decoded together W
+     * @param commit rounds committed per window C, 1 <= C <= W
+     */
+    SlidingWindowDecoder(std::shared_ptr<const Code> c, std::size_t window, std::size_t commit);
+
+    void setGrowth(GrowthVariant g);
+    /**
+     * Error rates of the phenomenological noise, used by weighted growth
+     */
+    void setErrorRates(double dataErrRate, double measurementErrRate);
+
+    /**
+     * Adds the measured syndrome of the next round and decodes a window if W rounds are buffered
+     * @return number of rounds committed by this call, 0 or C
+     */
+    std::size_t pushRound(const gf2Vec& syndrome);
+    /**
+     * Adds the perfect syndrome of the last round and commits all buffered rounds, the stream can be continued after reset
+     * @return number of rounds committed by this call
+     */
+    std::size_t finish(const gf2Vec& finalSyndrome);
+    /**
+     * Drops all rounds and the correction, keeps window size, growth and error rates
+     */
+    void reset();
+
+    /**
+     * Net correction of the data qubits of all committed rounds
+     */
+    [[nodiscard]] gf2Vec getCorrection() const {
+        return correction.toBoolVector();
+    }
+    [[nodiscard]] std::size_t getCommittedRounds() const {
+        return committedRounds;
+    }
+    [[nodiscard]] std::size_t getBufferedRounds() const {
+        return detectors.size();
+    }
+    [[nodiscard]] std::size_t getWindowRounds() const {
+        return windowRounds;
+    }
+    [[nodiscard]] std::size_t getCommitRounds() const {
+        return commitRounds;
+    }
+    [[nodiscard]] bool isFinished() const {
+        return finished;
+    }
+    /**
+     * Latencies of decoding and committing a window, including the final one
+     */
+    [[nodiscard]] const LatencyHistogram& getWindowLatencies() const {
+        return windowLatencies;
+    }
+
+private:
+    std::shared_ptr<const Code>                  code;
+    std::size_t                                  n;
+    std::size_t                                  m;
+    std::size_t                                  windowRounds;
+    std::size_t                                  commitRounds;
+    GrowthVariant                                growth = GrowthVariant::AllComponents;
+    std::optional<std::pair<double, double>>     errorRates{};  // data and measurement error rate
+    SpaceTimeGraph                               windowGraph;   // last round open to measurement errors
+    UFHeuristic                                  windowDecoder; // workspace kept between windows
+    std::vector<std::unique_ptr<SpaceTimeGraph>> finalGraphs{}; // perfect last round, built on demand, indexed by rounds - 1
+    UFHeuristic                                  finalDecoder;
+    std::deque<Gf2Vector>                        detectors{};    // detection events of the buffered rounds, oldest first
+    Gf2Vector                                    lastSyndrome;   // measured syndrome of the previous round
+    Gf2Vector                                    carry;          // detectors flipped by committed measurement errors, for the next round
+    Gf2Vector                                    correction;     // committed data correction
+    std::size_t                                  committedRounds = 0U;
+    bool                                         finished        = false;
+    LatencyHistogram                             windowLatencies{};
+
+    void        bufferRound(const gf2Vec& syndrome);
+    std::size_t decodeBuffered(const SpaceTimeGraph& graph, UFHeuristic& decoder, std::size_t nrCommit);
+};
+#endif // QECC_SLIDINGWINDOWDECODER_HPP
@@ -0,0 +1,140 @@
+#ifndef QECC_SPACETIMEGRAPH_HPP
+#define QECC_SPACETIMEGRAPH_HPP
+
+#include "Code.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+/**
+ * Decoding graph of repeated noisy syndrome measurements under phenomenological noise
+ * In each of T rounds the data qubits may flip and the measured syndrome may be wrong, except in the last round if it is
+ * perfect, e.g. a readout of the data qubits. The checks of the graph are detectors, that is changes of a
+ * syndrome bit between consecutive rounds, its bits are the possible faults:
+ * bit t*n+b is a flip of data qubit b before round t, it triggers the detectors of the checks of b in round t,
+ * bit T*n+t*m+c is a wrong measurement of check c in round t, it triggers the detectors of c in rounds t and t+1.
+ * If the last round is not perfect, as in a window of a longer experiment, its wrong measurements only trigger the detectors
+ * of their own round.
+ * Detector t*m+c belongs to check c in round t.
+ * The graph is built in compressed form from the Tanner graph of the code, so it takes space linear in T times the number of edges,
+ * and is decoded by UFHeuristic like the Tanner graph of a code
+ */
+class SpaceTimeGraph {
+public:
+    SpaceTimeGraph(const Code& code, const std::size_t rounds, const bool perfectLastRound = true) : nrRounds(rounds), n(code.gethZ()->nrBits()), m(code.gethZ()->nrChecks()), lastRoundPerfect(perfectLastRound) {
+        if (rounds == 0U) {
+            throw QeccException("Space-time graph needs at least one round");
+        }
+        if (rounds * (n + 2 * m) > std::numeric_limits<std::uint32_t>::max()) {
+            throw QeccException("Space-time graph too large for 32-bit indices");
+        }
+        const auto&                h = *code.gethZ();
+        std::vector<std::uint32_t> rowOffsets(rounds * m + 1U, 0U);
+        std::vector<std::uint32_t> rowBits;
+        rowBits.reserve(rounds * (h.checkNbrs.size() + 2 * m));
+        for (std::size_t t = 0; t < rounds; t++) {
+            for (std::size_t c = 0; c < m; c++) {
+                for (const auto b : h.getNbrs(n + c)) {
+                    rowBits.emplace_back(static_cast<std::uint32_t>(dataBit(t, b)));
+                }
+                if (t > 0U) {
+                    rowBits.emplace_back(static_cast<std::uint32_t>(measurementBit(t - 1, c)));
+                }
+                if (t + 1 < rounds || !perfectLastRound) {
+                    rowBits.emplace_back(static_cast<std::uint32_t>(measurementBit(t, c)));
+                }
+                rowOffsets[t * m + c + 1U] = static_cast<std::uint32_t>(rowBits.size());
+            }
+        }
+        const auto nrFaults = rounds * n + getMeasurementRounds() * m;
+        decodingCode        = std::make_shared<const Code>(std::make_unique<ParityCheckMatrix>(nrFaults, std::move(rowOffsets), std::move(rowBits)));
+    }
+
+    [[nodiscard]] std::size_t getRounds() const {
+        return nrRounds;
+    }
+    [[nodiscard]] bool isLastRoundPerfect() const {
+        return lastRoundPerfect;
+    }
+    /**
+     * Number of rounds with measurement errors, the first ones
+     */
+    [[nodiscard]] std::size_t getMeasurementRounds() const {
+        return lastRoundPerfect ? nrRounds - 1 : nrRounds;
+    }
+
+    /**
+     * Code whose Tanner graph is the decoding graph, to be set on the decoder
+     */
+    [[nodiscard]] const std::shared_ptr<const Code>& getDecodingCode() const {
+        return decodingCode;
+    }
+
+    [[nodiscard]] std::size_t dataBit(const std::size_t round, const std::size_t qubit) const {
+        return round * n + qubit;
+    }
+    [[nodiscard]] std::size_t measurementBit(const std::size_t round, const std::size_t check) const {
+        return nrRounds * n + round * m + check;
+    }
+
+    /**
+     * Detection events of the measured syndromes, the syndrome of the first round is compared to the trivial one
+     * @param syndromes one measured syndrome per round
+     * @return syndrome of the decoding graph
+     */
+    [[nodiscard]] Gf2Vector getDetectionEvents(const std::vector<Gf2Vector>& syndromes) const {
+        if (syndromes.size() != nrRounds) {
+            throw QeccException("Cannot compute detection events, need one syndrome per round");
+        }
+        Gf2Vector events(nrRounds * m);
+        for (std::size_t t = 0; t < nrRounds; t++) {
+            if (syndromes[t].size() != m) {
+                throw QeccException("Cannot compute detection events, syndrome has wrong size");
+            }
+            auto change = syndromes[t];
+            if (t > 0U) {
+                change ^= syndromes[t - 1];
+            }
+            change.forEachSetBit([&](const std::size_t c) { events.set(t * m + c); });
+        }
+        return events;
+    }
+
+    /**
+     * Net correction of the data qubits, the sum of the corrections of all rounds, measurement errors need no correction
+     * @param estimate estimate of the decoder on the decoding graph
+     */
+    [[nodiscard]] Gf2Vector getDataCorrection(const gf2Vec& estimate) const {
+        if (estimate.size() != decodingCode->getN()) {
+            throw QeccException("Cannot compute data correction, estimate has wrong size");
+        }
+        Gf2Vector res(n);
+        for (std::size_t t = 0; t < nrRounds; t++) {
+            for (std::size_t b = 0; b < n; b++) {
+                if (estimate[dataBit(t, b)]) {
+                    res.flip(b);
+                }
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Probabilities of all faults, e.g. for the weighted growth of UFHeuristic
+     */
+    [[nodiscard]] std::vector<double> getErrorProbabilities(const double dataErrRate, const double measurementErrRate) const {
+        std::vector<double> res(decodingCode->getN(), measurementErrRate);
+        std::fill(res.begin(), res.begin() + static_cast<std::int64_t>(nrRounds * n), dataErrRate);
+        return res;
+    }
+
+private:
+    std::size_t                 nrRounds;
+    std::size_t                 n; // data qubits
+    std::size_t                 m; // checks
+    bool                        lastRoundPerfect;
+    std::shared_ptr<const Code> decodingCode;
+};
+#endif // QECC_SPACETIMEGRAPH_HPP
@@ -0,0 +1,76 @@
+#ifndef QECC_STAMPEDSET_HPP
+#define QECC_STAMPEDSET_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Set of vertex indices from a fixed range that is reused between decoding runs
+ * Membership is marked by stamping the current generation, clearing only bumps the generation
+ * and thus costs time proportional to the number of elements inserted, not to the range
+ */
+class StampedSet {
+public:
+    StampedSet() = default;
+    explicit StampedSet(const std::size_t universe) {
+        resize(universe);
+    }
+
+    /**
+     * Sets the range of indices [0, universe) and clears the set, storage is only reallocated if the range grows
+     */
+    void resize(const std::size_t universe) {
+        if (universe > stamps.size()) {
+            stamps.assign(universe, 0U);
+            generation = 0U;
+        }
+        clear();
+    }
+
+    void clear() {
+        members.clear();
+        if (++generation == 0U) { // wrapped around, stale stamps could match again
+            std::fill(stamps.begin(), stamps.end(), 0U);
+            generation = 1U;
+        }
+    }
+
+    [[nodiscard]] bool contains(const std::size_t v) const {
+        return stamps[v] == generation;
+    }
+
+    /**
+     * @return true if v was not in the set before
+     */
+    bool insert(const std::size_t v) {
+        if (contains(v)) {
+            return false;
+        }
+        stamps[v] = generation;
+        members.emplace_back(v);
+        return true;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return members.size();
+    }
+    [[nodiscard]] bool empty() const {
+        return members.empty();
+    }
+    [[nodiscard]] std::size_t operator[](const std::size_t i) const {
+        return members[i];
+    }
+    [[nodiscard]] auto begin() const {
+        return members.begin();
+    }
+    [[nodiscard]] auto end() const {
+        return members.end();
+    }
+
+private:
+    std::vector<std::uint32_t> stamps;
+    std::vector<std::size_t>   members; // in insertion order
+    std::uint32_t              generation = 0U;
+};
+#endif // QECC_STAMPEDSET_HPP
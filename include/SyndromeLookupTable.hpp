@@ -0,0 +1,92 @@
+#ifndef QECC_SYNDROMELOOKUPTABLE_HPP
+#define QECC_SYNDROMELOOKUPTABLE_HPP
+
+#include "Code.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct LookupTableConfig {
+    std::size_t maxWeight = 2U;                    // largest weight of the tabulated errors
+    std::size_t maxBytes  = std::size_t{1U} << 28U; // memory budget of the table and its build, weights that do not fit are left out
+    std::size_t nrThreads = 0U;                    // threads building the table, 0 for all hardware threads
+};
+
+/**
+ * Table of minimum-weight corrections of all syndromes caused by errors of weight at most w
+ * Syndromes are keyed by a 64-bit hash of their sorted check indices in an open-addressing table, so a lookup costs a pass over
+ * the syndrome words and a probe. The stored correction is checked against the syndrome, hash collisions fall through to the
+ * decoder instead of returning a wrong correction.
+ * Errors are enumerated by increasing weight, among errors of equal weight the lexicographically smallest one is kept.
+ * The table is built in parallel from the adjacency of the check matrix and can be cached on disk, a cached table is only
+ * used for the check matrix it was built from
+ */
+class SyndromeLookupTable {
+public:
+    static constexpr std::uint64_t FORMAT_VERSION = 1U;
+
+    explicit SyndromeLookupTable(const ParityCheckMatrix& pcm, const LookupTableConfig& config = {});
+
+    /**
+     * Reads a table written by save
+     * @param path file written by save
+     * @param pcm check matrix the table is used for, has to be the one it was built from
+     */
+    static SyndromeLookupTable load(const std::string& path, const ParityCheckMatrix& pcm);
+    /**
+     * Reads the table from the cache file if it was built for the same check matrix and configuration, otherwise builds it
+     * and writes it to the cache file
+     */
+    static SyndromeLookupTable loadOrBuild(const std::string& path, const ParityCheckMatrix& pcm, const LookupTableConfig& config = {});
+    void                       save(const std::string& path) const;
+
+    /**
+     * Looks up the correction of the syndrome
+     * @param syndrome syndrome of the check matrix the table was built from
+     * @param pcm check matrix the table was built from, used to check the stored correction
+     * @param correction indices of the flipped bits if found
+     * @return true if the syndrome is caused by an error of weight at most getMaxWeight()
+     */
+    bool lookup(const Gf2Vector& syndrome, const ParityCheckMatrix& pcm, std::vector<std::size_t>& correction) const;
+
+    /**
+     * Hash of the adjacency of the check matrix, identifies the matrix a table was built from
+     */
+    [[nodiscard]] static std::uint64_t fingerprint(const ParityCheckMatrix& pcm);
+
+    [[nodiscard]] bool matches(const ParityCheckMatrix& pcm) const {
+        return pcm.nrBits() == nrBits && pcm.nrChecks() == nrChecks && fingerprint(pcm) == pcmFingerprint;
+    }
+    [[nodiscard]] std::size_t size() const {
+        return nrEntries;
+    }
+    /**
+     * Largest weight of the tabulated errors, can be below the configured weight if the memory budget is exceeded
+     */
+    [[nodiscard]] std::size_t getMaxWeight() const {
+        return maxWeight;
+    }
+    [[nodiscard]] std::size_t memoryBytes() const {
+        return keys.size() * sizeof(std::uint64_t) + entries.size() * sizeof(std::uint32_t) + corrections.size() * sizeof(std::uint32_t);
+    }
+
+private:
+    SyndromeLookupTable() = default;
+
+    std::size_t                nrBits            = 0U;
+    std::size_t                nrChecks          = 0U;
+    std::uint64_t              pcmFingerprint    = 0U;
+    std::size_t                requestedWeight   = 0U; // configuration the table was built with, for the cache
+    std::size_t                requestedBytes    = 0U;
+    std::size_t                maxWeight         = 0U;
+    std::size_t                maxSyndromeWeight = 0U; // larger syndromes are not looked up
+    std::size_t                nrEntries         = 0U;
+    std::vector<std::uint64_t> keys{};        // syndrome hashes, 0 for empty slots, size is a power of two
+    std::vector<std::uint32_t> entries{};     // offset of the correction of a slot
+    std::vector<std::uint32_t> corrections{}; // weight followed by the bit indices of each correction
+
+    static double      tableBytes(std::size_t bits, std::size_t weight);
+    void               insert(std::uint64_t key, const std::uint32_t* bits, std::size_t weight);
+};
+#endif // QECC_SYNDROMELOOKUPTABLE_HPP
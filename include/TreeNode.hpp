@@ -18,8 +18,8 @@ class TreeNode {
 public:
     std::size_t                     vertexIdx = 0U;
     bool                            isCheck   = false;
-    TreeNode*                       parent    = nullptr;
-    std::vector<TreeNode*>          children{};
+    TreeNode*                       parent      = nullptr;
+    std::size_t                     rank        = 0U;
     std::size_t                     clusterSize = 1U;
     std::unordered_set<std::size_t> boundaryVertices{};
     std::vector<std::size_t>        checkVertices{};
@@ -33,21 +33,22 @@ public:
     }
 
     /*
-     * find using path compression
+     * find using full path compression, all nodes on the path are attached to the root
      */
     static TreeNode* Find(TreeNode* node) { // NOLINT(readability-identifier-naming)
-        auto* parent = node->parent;
-        while (parent != nullptr && parent->parent != nullptr) {
-            node   = parent;
-            parent = parent->parent;
+        auto* root = node;
+        while (root->parent != nullptr) {
+            root = root->parent;
         }
-        if (parent == nullptr) {
-            return node;
+        while (node != root) {
+            auto* next   = node->parent;
+            node->parent = root;
+            node         = next;
         }
-        return parent;
+        return root;
     }
     /*
-     * Merge two trees with given roots
+     * Merge two trees with given roots using union by rank
      */
     static void Union(TreeNode* tree1, TreeNode* tree2) { // NOLINT(readability-identifier-naming)
         auto* root1 = Find(tree1);
@@ -56,7 +57,10 @@ public:
         if (root1->vertexIdx == root2->vertexIdx) {
             return;
         }
-        if (root1->clusterSize <= root2->clusterSize) {
+        if (root1->rank <= root2->rank) {
+            if (root1->rank == root2->rank) {
+                root2->rank++;
+            }
             addFirstToSecondTree(root1, root2);
         } else {
             addFirstToSecondTree(root2, root1);
@@ -65,7 +69,6 @@ public:
 
     static void addFirstToSecondTree(TreeNode* first, TreeNode* second) {
         first->parent = second;
-        second->children.emplace_back(first);
         second->clusterSize += first->clusterSize;
         std::move(first->checkVertices.begin(), first->checkVertices.end(), std::back_inserter(second->checkVertices));
 
@@ -95,7 +98,7 @@ public:
     }
 
     friend std::ostream& operator<<(std::ostream& os, const TreeNode& v) {
-        return os << "idx: " << v.vertexIdx << "parentIx: " << v.parent->vertexIdx << "check: " << v.isCheck << "children: " << v.children.size();
+        return os << "idx: " << v.vertexIdx << "parentIx: " << v.parent->vertexIdx << "check: " << v.isCheck << "rank: " << v.rank;
     }
 
     friend std::ostream& operator<<(std::ostream& os, const std::unordered_set<TreeNode>& v) {
@@ -5,6 +5,9 @@
 #ifndef QUNIONFIND_IMPROVEDUF_HPP
 #define QUNIONFIND_IMPROVEDUF_HPP
 #include "Decoder.hpp"
+#include "StampedSet.hpp"
+
+#include <unordered_set>
 class UFDecoder : public Decoder {
 public:
     using Decoder::Decoder;
@@ -12,17 +15,21 @@ public:
     void reset() override;
 
 private:
-    void                                                       doDecode(const std::vector<bool>& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm);
-    [[nodiscard]] bool                                         isValidComponent(const std::unordered_set<std::size_t>& nodeSet, const std::unordered_set<std::size_t>& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm) const;
-    bool                                                       containsInvalidComponents(const std::unordered_set<std::size_t>& nodeSet, const std::unordered_set<std::size_t>& syndrome,
+    StampedSet                                                 components{}; // workspaces reused between runs
+    StampedSet                                                 syndr{};
+    mutable StampedSet                                         visited{};
+    mutable StampedSet                                         usedChecks{};
+    void                                                       doDecode(const Gf2Vector& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm);
+    [[nodiscard]] bool                                         isValidComponent(const std::unordered_set<std::size_t>& nodeSet, const StampedSet& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm) const;
+    bool                                                       containsInvalidComponents(const StampedSet& nodeSet, const StampedSet& syndrome,
                                                                                          std::vector<std::unordered_set<std::size_t>>& invalidComps, const std::unique_ptr<ParityCheckMatrix>& pcm) const;
     [[nodiscard]] std::vector<std::size_t>                     computeInteriorBitNodes(const std::unordered_set<std::size_t>& nodeSet) const;
-    [[nodiscard]] std::unordered_set<std::size_t>              getEstimateForComponent(const std::unordered_set<std::size_t>& nodeSet, const std::unordered_set<std::size_t>& syndrome,
+    [[nodiscard]] std::unordered_set<std::size_t>              getEstimateForComponent(const std::unordered_set<std::size_t>& nodeSet, const StampedSet& syndrome,
                                                                                        const std::unique_ptr<ParityCheckMatrix>& pcm) const;
-    void                                                       standardGrowth(std::unordered_set<std::size_t>& comps);
-    void                                                       singleClusterSmallestFirstGrowth(std::unordered_set<std::size_t>& nodeSet);
-    void                                                       singleClusterRandomFirstGrowth(std::unordered_set<std::size_t>& nodeSet);
-    void                                                       singleQubitRandomFirstGrowth(std::unordered_set<std::size_t>& comps);
-    [[nodiscard]] std::vector<std::unordered_set<std::size_t>> getConnectedComps(const std::unordered_set<std::size_t>& nodes) const;
+    void                                                       standardGrowth(StampedSet& comps);
+    void                                                       singleClusterSmallestFirstGrowth(StampedSet& nodeSet);
+    void                                                       singleClusterRandomFirstGrowth(StampedSet& nodeSet);
+    void                                                       singleQubitRandomFirstGrowth(StampedSet& comps);
+    [[nodiscard]] std::vector<std::unordered_set<std::size_t>> getConnectedComps(const StampedSet& nodes) const;
 };
 #endif // QUNIONFIND_IMPROVEDUF_HPP
@@ -5,6 +5,8 @@
 #ifndef QUNIONFIND_IMPROVEDUFD_HPP
 #define QUNIONFIND_IMPROVEDUFD_HPP
 #include "Decoder.hpp"
+#include "StampedSet.hpp"
+#include "UnionFindArena.hpp"
 
 #include <unordered_set>
 namespace std {
@@ -23,23 +25,49 @@ struct hash<std::pair<std::size_t, std::size_t>> {
 class UFHeuristic : public Decoder {
 public:
     using Decoder::Decoder;
+    static constexpr double WEIGHT_SCALE = 100.0; // integer weight units per unit of log-likelihood ratio
+
     void decode(const gf2Vec& syndrome) override;
     void reset() override;
+    /**
+     * Sets the weights used by weighted growth to log((1-p)/p) of the given per-qubit error probabilities, rounded to integers
+     * Qubits with p >= 0.5 get the smallest weight 1. Without probabilities all qubits have weight 1
+     * @param probabilities one per qubit, in (0, 1)
+     */
+    void setErrorProbabilities(const std::vector<double>& probabilities);
+    [[nodiscard]] const std::vector<std::uint32_t>& getQubitWeights() const {
+        return qubitWeights;
+    }
 
 private:
-    // do not call.at only getNodeFromIdx()
-    std::unordered_map<std::size_t, std::unique_ptr<TreeNode>> nodeMap{};
-    TreeNode*                                                  getNodeFromIdx(std::size_t idx);
-    void                                                       standardGrowth(std::vector<std::pair<std::size_t, std::size_t>>& fusionEdges,
-                                                                              std::unordered_map<std::size_t, bool>& presentMap, const std::unordered_set<std::size_t>& components, const std::unique_ptr<ParityCheckMatrix>& pcm);
-    void                                                       singleClusterRandomFirstGrowth(std::vector<std::pair<std::size_t, std::size_t>>& fusionEdges,
-                                                                                              std::unordered_map<std::size_t, bool>& presentMap, const std::unordered_set<std::size_t>& components, const std::unique_ptr<ParityCheckMatrix>& pcm);
-    void                                                       singleClusterSmallestFirstGrowth(std::vector<std::pair<std::size_t, std::size_t>>& fusionEdges,
-                                                                                                std::unordered_map<std::size_t, bool>& presentMap, const std::unordered_set<std::size_t>& components, const std::unique_ptr<ParityCheckMatrix>& pcm);
-    bool                                                       isValidComponent(const std::size_t& compId, const std::unique_ptr<ParityCheckMatrix>& pcm);
-    std::vector<std::size_t>                                   erasureDecoder(std::unordered_set<std::size_t>& erasure, std::unordered_set<std::size_t>& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm);
-    void                                                       extractValidComponents(std::unordered_set<std::size_t>& invalidComponents, std::unordered_set<std::size_t>& validComponents, const std::unique_ptr<ParityCheckMatrix>& pcm);
-    std::unordered_set<std::size_t>                            computeInitTreeComponents(const gf2Vec& syndrome);
-    void                                                       doDecoding(const gf2Vec& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm);
+    UnionFindArena                                   arena{};            // reset in constant time between runs
+    std::vector<std::pair<std::size_t, std::size_t>> fusionEdgeBuffer{}; // reused between growth steps
+    StampedSet                                       peelChecks{};       // checks of the spanning forest in search order, rows of the reduced system
+    StampedSet                                       clusterBits{};      // columns of the reduced system
+    std::vector<std::uint32_t>                       peelParentBit{};    // tree edge to the parent of a check, NIL for roots
+    std::vector<std::uint32_t>                       peelParentCheck{};  // NIL for roots and checks attached to the boundary
+    std::vector<std::uint8_t>                        peelParity{};       // syndrome left on a check while peeling
+    std::vector<std::uint32_t>                       reducedColumn{};    // column of a bit in the reduced system
+    std::vector<std::uint32_t>                       qubitWeights{};     // empty for uniform weights, kept between runs
+    StampedSet                                       grownBits{};        // bits with growth progress in this run
+    StampedSet                                       candidateBits{};    // bits reached by the current growth step
+    std::vector<std::uint32_t>                       growthProgress{};   // grown part of the weight of a bit
+    std::vector<std::uint32_t>                       growthRate{};       // number of boundary checks growing towards a bit
+    void                                             standardGrowth(std::vector<std::pair<std::size_t, std::size_t>>& fusionEdges, const std::unordered_set<std::size_t>& components, const std::unique_ptr<ParityCheckMatrix>& pcm);
+    void                                             singleClusterRandomFirstGrowth(std::vector<std::pair<std::size_t, std::size_t>>& fusionEdges, const std::unordered_set<std::size_t>& components, const std::unique_ptr<ParityCheckMatrix>& pcm);
+    void                                             singleClusterSmallestFirstGrowth(std::vector<std::pair<std::size_t, std::size_t>>& fusionEdges, const std::unordered_set<std::size_t>& components, const std::unique_ptr<ParityCheckMatrix>& pcm);
+    void                                             weightedGrowth(std::vector<std::pair<std::size_t, std::size_t>>& fusionEdges, const std::unordered_set<std::size_t>& components, const std::unique_ptr<ParityCheckMatrix>& pcm);
+    [[nodiscard]] std::uint32_t                      weightOf(std::size_t bit) const;
+    void                                             growCluster(std::vector<std::pair<std::size_t, std::size_t>>& fusionEdges, std::size_t root, const std::unique_ptr<ParityCheckMatrix>& pcm) const;
+    bool                                             isValidComponent(const std::size_t& compId, const std::unique_ptr<ParityCheckMatrix>& pcm);
+    bool                                             isErased(std::size_t v, std::size_t root);
+    bool                                             peelCluster(std::size_t root, const std::unordered_set<std::size_t>& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm, std::vector<std::size_t>& estimate);
+    bool                                             solveCluster(std::size_t root, const std::unordered_set<std::size_t>& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm, bool withBoundary, std::vector<std::size_t>& estimate);
+    bool                                             solveReduced(const std::unordered_set<std::size_t>& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm, std::vector<std::size_t>& estimate);
+    bool                                             solveResidual(const std::vector<std::size_t>& unsolvedRoots, const std::unordered_set<std::size_t>& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm, std::vector<std::size_t>& estimate);
+    bool                                             erasureDecoder(std::unordered_set<std::size_t>& erasure, std::unordered_set<std::size_t>& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm, std::vector<std::size_t>& estimate);
+    void                                             extractValidComponents(std::unordered_set<std::size_t>& invalidComponents, std::unordered_set<std::size_t>& validComponents, const std::unique_ptr<ParityCheckMatrix>& pcm);
+    std::unordered_set<std::size_t>                  computeInitTreeComponents(const Gf2Vector& syndrome);
+    void                                             doDecoding(const Gf2Vector& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm);
 };
 #endif // QUNIONFIND_IMPROVEDUFD_HPP
@@ -0,0 +1,239 @@
+#ifndef QECC_UNIONFINDARENA_HPP
+#define QECC_UNIONFINDARENA_HPP
+
+#include "QeccException.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * Union Find data structure over the vertices of a Tanner graph, stored as flat arrays indexed by vertex
+ * Each cluster keeps an intrusive list of its members and of its boundary vertices in the root,
+ * merging two clusters splices these lists in constant time
+ * Vertices are initialized lazily when first touched after a reset, entries of earlier runs are recognized by their generation stamp
+ */
+class UnionFindArena {
+public:
+    static constexpr std::uint32_t NIL = std::numeric_limits<std::uint32_t>::max();
+
+    UnionFindArena() = default;
+    explicit UnionFindArena(const std::size_t nrNodes) {
+        reset(nrNodes);
+    }
+
+    /**
+     * Makes every vertex a singleton cluster whose boundary is the vertex itself
+     * Runs in constant time unless the number of vertices changes
+     * @param nrNodes number of vertices
+     */
+    void reset(const std::size_t nrNodes) {
+        if (nrNodes >= NIL) {
+            throw QeccException("Too many vertices for union find arena");
+        }
+        if (nrNodes != stamp.size()) {
+            parent.resize(nrNodes);
+            rank.resize(nrNodes);
+            clusterSize.resize(nrNodes);
+            memberNext.resize(nrNodes);
+            memberTail.resize(nrNodes);
+            bndryNext.resize(nrNodes);
+            bndryHead.resize(nrNodes);
+            bndryTail.resize(nrNodes);
+            boundary.resize(nrNodes);
+            parity.resize(nrNodes);
+            open.resize(nrNodes);
+            stamp.assign(nrNodes, 0U);
+            generation = 0U;
+        }
+        if (++generation == 0U) { // wrapped around, stale stamps could match again
+            std::fill(stamp.begin(), stamp.end(), 0U);
+            generation = 1U;
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return stamp.size();
+    }
+
+    /**
+     * Finds the root of the cluster containing v, halving the path on the way
+     */
+    std::size_t find(std::size_t v) {
+        touch(v);
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v         = parent[v];
+        }
+        return v;
+    }
+
+    /**
+     * Number of parent links from v to its root, for diagnostics
+     */
+    [[nodiscard]] std::size_t depth(std::size_t v) const {
+        std::size_t d = 0U;
+        while (isLive(v) && parent[v] != v) {
+            v = parent[v];
+            d++;
+        }
+        return d;
+    }
+
+    /**
+     * Merges the clusters with the given roots using union by rank
+     * @return the root of the merged cluster
+     */
+    std::size_t unite(const std::size_t root1, const std::size_t root2) {
+        if (root1 == root2) {
+            return root1;
+        }
+        touch(root1);
+        touch(root2);
+        const auto child = rank[root1] <= rank[root2] ? root1 : root2;
+        const auto root  = child == root1 ? root2 : root1;
+        if (rank[child] == rank[root]) {
+            rank[root]++;
+        }
+        clusterSize[root] += clusterSize[child];
+        parity[root] ^= parity[child];
+        open[root] |= open[child];
+
+        parent[child] = static_cast<std::uint32_t>(root);
+        // member lists always start at their root and are never empty
+        memberNext[memberTail[root]] = static_cast<std::uint32_t>(child);
+        memberTail[root]             = memberTail[child];
+        if (bndryHead[child] != NIL) {
+            if (bndryHead[root] == NIL) {
+                bndryHead[root] = bndryHead[child];
+            } else {
+                bndryNext[bndryTail[root]] = bndryHead[child];
+            }
+            bndryTail[root] = bndryTail[child];
+        }
+        bndryHead[child] = NIL;
+        bndryTail[child] = NIL;
+        return root;
+    }
+
+    [[nodiscard]] std::size_t getClusterSize(const std::size_t root) const {
+        return isLive(root) ? clusterSize[root] : 1U;
+    }
+
+    [[nodiscard]] bool isBoundary(const std::size_t v) const {
+        return !isLive(v) || boundary[v] != 0U;
+    }
+
+    template <class F>
+    void forEachMember(const std::size_t root, F&& f) const {
+        if (!isLive(root)) {
+            f(root);
+            return;
+        }
+        for (auto v = static_cast<std::uint32_t>(root); v != NIL; v = memberNext[v]) {
+            f(static_cast<std::size_t>(v));
+        }
+    }
+
+    template <class F>
+    void forEachBoundaryVertex(const std::size_t root, F&& f) const {
+        if (!isLive(root)) {
+            f(root);
+            return;
+        }
+        for (auto v = bndryHead[root]; v != NIL; v = bndryNext[v]) {
+            f(static_cast<std::size_t>(v));
+        }
+    }
+
+    /**
+     * Removes all vertices from the boundary list of the cluster for which keep returns false
+     */
+    template <class Pred>
+    void filterBoundary(const std::size_t root, Pred&& keep) {
+        touch(root);
+        auto last = NIL;
+        auto v    = bndryHead[root];
+        while (v != NIL) {
+            const auto next = bndryNext[v];
+            if (keep(static_cast<std::size_t>(v))) {
+                if (last == NIL) {
+                    bndryHead[root] = v;
+                } else {
+                    bndryNext[last] = v;
+                }
+                last = v;
+            } else {
+                boundary[v] = 0U;
+            }
+            bndryNext[v] = NIL;
+            v            = next;
+        }
+        if (last == NIL) {
+            bndryHead[root] = NIL;
+        }
+        bndryTail[root] = last;
+    }
+
+    /**
+     * Adds a syndrome check to the cluster with the given root, flipping its parity
+     */
+    void flipParity(const std::size_t root) {
+        touch(root);
+        parity[root] ^= 1U;
+    }
+    /**
+     * Marks the cluster with the given root as able to change its parity, e.g. by a bit with an odd number of checks
+     */
+    void setOpen(const std::size_t root) {
+        touch(root);
+        open[root] = 1U;
+    }
+    /**
+     * A cluster can only explain its syndrome if its parity is even or it is open, kept up to date by unite in constant time
+     */
+    [[nodiscard]] bool isNeutral(const std::size_t root) const {
+        return !isLive(root) || parity[root] == 0U || open[root] != 0U;
+    }
+
+private:
+    [[nodiscard]] bool isLive(const std::size_t v) const {
+        return stamp[v] == generation;
+    }
+
+    void touch(const std::size_t v) {
+        if (isLive(v)) {
+            return;
+        }
+        const auto idx = static_cast<std::uint32_t>(v);
+        stamp[v]       = generation;
+        parent[v]      = idx;
+        rank[v]        = 0U;
+        clusterSize[v] = 1U;
+        memberNext[v]  = NIL;
+        memberTail[v]  = idx;
+        bndryNext[v]   = NIL;
+        bndryHead[v]   = idx;
+        bndryTail[v]   = idx;
+        boundary[v]    = 1U;
+        parity[v]      = 0U;
+        open[v]        = 0U;
+    }
+
+
+    std::vector<std::uint32_t> parent;
+    std::vector<std::uint8_t>  rank; // bounded by log2 of the number of vertices
+    std::vector<std::uint32_t> clusterSize;
+    std::vector<std::uint32_t> memberNext; // next vertex of the same cluster
+    std::vector<std::uint32_t> memberTail; // valid for roots
+    std::vector<std::uint32_t> bndryNext;  // next boundary vertex of the same cluster
+    std::vector<std::uint32_t> bndryHead;  // valid for roots, NIL if the cluster has no boundary
+    std::vector<std::uint32_t> bndryTail;
+    std::vector<std::uint8_t>  boundary; // flags, vector<bool> would pack them but costs a shift per access
+    std::vector<std::uint8_t>  parity;   // valid for roots, number of syndrome checks of the cluster mod 2
+    std::vector<std::uint8_t>  open;     // valid for roots
+    std::vector<std::uint32_t> stamp;    // generation in which the vertex was last initialized
+    std::uint32_t              generation = 0U;
+};
+#endif // QECC_UNIONFINDARENA_HPP
@@ -4,12 +4,19 @@
 #ifndef QUNIONFIND_UTILS_HPP
 #define QUNIONFIND_UTILS_HPP
 
+#include "Gf2.hpp"
 #include "QeccException.hpp"
+#include "RandomStream.hpp"
 #include "TreeNode.hpp"
 #include "nlohmann/json.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#ifdef QECC_WITH_FLINT
 #include <flint/nmod_matxx.h>
+#endif
 #include <fstream>
 #include <iostream>
 #include <ostream>
@@ -17,16 +24,12 @@
 #include <set>
 #include <vector>
 
-using gf2Mat = std::vector<std::vector<bool>>;
-using gf2Vec = std::vector<bool>;
-
 class Utils {
 public:
-    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-array-to-pointer-decay)
     /**
-     * Uses flint's integers mod n matrix package nnmod_mat to solve the system given by Mx=b
+     * Solves the system given by Mx=b over GF(2) using bit-packed row reduction
      * Returns x if there is a solution, or an empty vector if there is no solution
-     * By the behaviour of flint's solve function, if there are multiple valid solutions one is returned
+     * If there are multiple valid solutions one is returned
      * @param inmat
      * @param vec
      * @return
@@ -34,60 +37,63 @@ public:
     static gf2Vec solveSystem(const gf2Mat& inmat, const gf2Vec& vec) {
         assertMatrixPresent(inmat);
         assertVectorPresent(vec);
-        if (inmat.size() > std::numeric_limits<long int>::max() || inmat.front().size() > std::numeric_limits<long int>::max()) { // NOLINT(google-runtime-int)
-            throw QeccException("size of matrix too large for flint");
+        const auto res = solveSystem(Gf2Matrix(inmat), Gf2Vector(vec));
+        if (res.empty()) {
+            return gf2Vec{};
         }
-        if (inmat.size() != vec.size()) { // NOLINT(readability-else-after-return)
+        return res.toBoolVector();
+    }
+
+    /**
+     * Solves the system Mx=b for bit-packed inputs
+     * Returns x if there is a solution, or an empty vector if there is no solution
+     * @param inmat
+     * @param vec
+     * @return
+     */
+    static Gf2Vector solveSystem(const Gf2Matrix& inmat, const Gf2Vector& vec) {
+        if (inmat.empty()) {
+            throw QeccException("Matrix is empty");
+        }
+        if (vec.empty()) {
+            throw QeccException("Vector is empty");
+        }
+        if (inmat.rows() != vec.size()) {
             std::cerr << "Cannot solve system, dimensions do not match" << std::endl;
             throw QeccException("Cannot solve system, dimensions do not match");
         }
+        return inmat.solve(vec);
+    }
 
-        gf2Vec          result{};
-        slong           rows = static_cast<std::int64_t>(inmat.size());
-        slong           cols = static_cast<std::int64_t>(inmat.front().size());
-        nmod_mat_t      mat;
-        nmod_mat_t      x;
-        nmod_mat_t      b;
-        mp_limb_t const mod = 2;
-        // initializes mat to rows x cols matrix with coefficients mod 2
-        nmod_mat_init(mat, rows, cols, mod); // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay)
-        nmod_mat_init(x, cols, 1, mod);
-        nmod_mat_init(b, rows, 1, mod);
-
-        for (slong i = 0; i < nmod_mat_nrows(mat); i++) {
-            for (slong j = 0; j < nmod_mat_ncols(mat); j++) {
-                nmod_mat_set_entry(mat, i, j, inmat.at(static_cast<std::uint64_t>(i)).at(static_cast<std::uint64_t>(j)) ? 1U : 0U);
-            }
-        }
-        slong bColIdx = nmod_mat_ncols(b) - 1;
-        for (slong i = 0; i < nmod_mat_nrows(b); i++) {
-            nmod_mat_set_entry(b, i, bColIdx, vec.at(static_cast<std::uint64_t>(i)) ? 1U : 0U);
-        }
-        int const sol = nmod_mat_can_solve(x, mat, b);
+    /**
+     * Computes the reduced row echelon form of the given matrix
+     * @param matrix
+     * @return
+     */
+    static gf2Mat gauss(const gf2Mat& matrix) {
+        assertMatrixPresent(matrix);
+        Gf2Matrix res(matrix);
+        res.rref();
+        return res.toBoolMatrix();
+    }
 
-        if (sol == 1) {
-            result       = gf2Vec(static_cast<std::uint64_t>(nmod_mat_nrows(x)));
-            auto xColIdx = nmod_mat_ncols(x) - 1;
-            for (auto i = 0; i < nmod_mat_nrows(x); i++) {
-                result.at(static_cast<std::size_t>(i)) = nmod_mat_get_entry(x, i, xColIdx); // NOLINT(readability-implicit-bool-conversion)
-            }
-        } else {
-            // no solution
-        }
-        nmod_mat_clear(mat);
-        nmod_mat_clear(x);
-        nmod_mat_clear(b);
-        return result;
+    static std::size_t getRank(const gf2Mat& matrix) {
+        assertMatrixPresent(matrix);
+        return Gf2Matrix(matrix).rank();
     }
-    // NOLINTEND(cppcoreguidelines-pro-bounds-array-to-pointer-decay)
 
-    static flint::nmod_matxx gauss(const gf2Mat& matrix) {
+    /**
+     * Computes a basis of the kernel {x : Mx = 0}, one basis vector per row
+     * @param matrix
+     * @return
+     */
+    static gf2Mat getNullspace(const gf2Mat& matrix) {
         assertMatrixPresent(matrix);
-        auto res = getFlintMatrix(matrix);
-        res.set_rref(); // reduced row echelon form
-        return res;
+        return Gf2Matrix(matrix).nullspace().toBoolMatrix();
     }
 
+#ifdef QECC_WITH_FLINT
+    // conversions to flint's nmod_mat, only available if the library is built with FLINT
     static flint::nmod_matxx getFlintMatrix(const gf2Mat& matrix) {
         assertMatrixPresent(matrix);
         const slong     rows    = static_cast<slong>(matrix.size());
@@ -126,6 +132,7 @@ public:
         }
         return result;
     }
+#endif
 
     /**
      * Checks if the given vector is in the rowspace of matrix M
@@ -136,36 +143,21 @@ public:
     static bool isVectorInRowspace(const gf2Mat& inmat, const gf2Vec& vec) {
         assertMatrixPresent(inmat);
         assertVectorPresent(vec);
-        if (std::none_of(vec.begin(), vec.end(), [](const bool val) { return val; })) { // all zeros vector trivial
-            return true;
-        }
-        gf2Mat matrix;
-        if (vec.size() == inmat.at(0).size()) {
-            matrix = getTranspose(inmat); // v is in rowspace of M <=> v is in col space of M^T
-        } else {
-            throw QeccException("Cannot check if in rowspace, dimensions of matrix and vector do not match");
-        }
+        return isVectorInRowspace(Gf2Matrix(inmat), Gf2Vector(vec));
+    }
 
-        for (std::size_t i = 0; i < matrix.size(); i++) {
-            matrix.at(i).emplace_back(vec.at(i));
+    static bool isVectorInRowspace(const Gf2Matrix& inmat, const gf2Vec& vec) {
+        return isVectorInRowspace(inmat, Gf2Vector(vec));
+    }
+
+    static bool isVectorInRowspace(const Gf2Matrix& inmat, const Gf2Vector& vec) {
+        if (inmat.empty()) {
+            throw QeccException("Matrix is empty");
         }
-        auto reduced = gauss(matrix);
-        // flint::print_pretty(reduced);
-        //  check consistency, inconsistent <=> vec not in rowspace
-        for (slong i = 0; i < reduced.rows(); i++) {
-            if (reduced.at(i, reduced.cols() - 1)._limb() == 1) {
-                bool inconsistent = true;
-                for (slong k = 0; k < (reduced.cols() - 1); k++) {
-                    if (reduced.at(i, k)._limb() == 1) {
-                        inconsistent = false;
-                    }
-                }
-                if (inconsistent) {
-                    return false;
-                }
-            }
+        if (vec.empty()) {
+            throw QeccException("Vector is empty");
         }
-        return true;
+        return inmat.isInRowspace(vec);
     }
 
     /**
@@ -208,6 +200,23 @@ public:
         }
     }
 
+    /**
+     * Computes matrix vector product over bit-packed rows and adds it to the result vector
+     * @param m1
+     * @param vec
+     * @param result
+     */
+    static void rectMatrixMultiply(const Gf2Matrix& m1, const Gf2Vector& vec, Gf2Vector& result) {
+        if (m1.empty() || vec.empty() || m1.cols() != vec.size() || m1.rows() != result.size()) {
+            throw QeccException("Cannot multiply, dimensions wrong");
+        }
+        for (std::size_t i = 0; i < m1.rows(); i++) {
+            if (m1.rowDot(i, vec)) {
+                result.flip(i);
+            }
+        }
+    }
+
     static void assertMatrixPresent(const gf2Mat& matrix) {
         if (matrix.empty() || matrix.at(0).empty()) {
             throw QeccException("Matrix is empty");
@@ -260,6 +269,14 @@ public:
         return s.str();
     }
 
+    static std::string getStringFrom(const Gf2Matrix& matrix) {
+        return getStringFrom(matrix.toBoolMatrix());
+    }
+
+    static std::string getStringFrom(const Gf2Vector& vector) {
+        return getStringFrom(vector.toBoolVector());
+    }
+
     static std::string getStringFrom(const gf2Vec& vector) {
         if (vector.empty()) {
             return "[]";
@@ -285,19 +302,170 @@ public:
      * @return
      */
     static gf2Vec sampleErrorIidPauliNoise(const std::size_t n, const double physicalErrRate) {
-        std::random_device rd;
-        std::mt19937_64    gen(rd());
-        gf2Vec             result;
-        result.reserve(n);
-
-        // Set up the weights, iid noise for each bit
-        std::bernoulli_distribution d(physicalErrRate);
-        for (std::size_t i = 0; i < n; i++) {
-            result.emplace_back(d(gen));
+        // seeded once per thread, concurrent callers do not share generator state
+        thread_local std::mt19937_64 gen(std::random_device{}());
+        return sampleErrorIidPauliNoise(n, physicalErrRate, gen);
+    }
+
+    /**
+     * Same as above but draws from the given generator, so that samples are reproducible from its seed
+     * @param n
+     * @param physicalErrRate
+     * @param gen
+     * @return
+     */
+    template <class Engine>
+    static gf2Vec sampleErrorIidPauliNoise(const std::size_t n, const double physicalErrRate, Engine& gen) {
+        gf2Vec result(n, false);
+        forEachIidFlip(n, physicalErrRate, gen, [&result](const std::size_t pos) { result[pos] = true; });
+        return result;
+    }
+
+    /**
+     * Samples an n-qubit iid error as the sorted list of flipped qubit indices
+     * Takes O(n * physicalErrRate) expected time, independent of n for a fixed expected number of flips,
+     * the result can be passed to ParityCheckMatrix::getSyndromeFromSupport directly
+     * @param n
+     * @param physicalErrRate
+     * @param gen
+     * @return
+     */
+    template <class Engine>
+    static std::vector<std::size_t> sampleSparseErrorIidPauliNoise(const std::size_t n, const double physicalErrRate, Engine& gen) {
+        std::vector<std::size_t> result;
+        if (physicalErrRate > 0.0) {
+            result.reserve(static_cast<std::size_t>(std::ceil(static_cast<double>(n) * std::min(physicalErrRate, 1.0))));
         }
+        forEachIidFlip(n, physicalErrRate, gen, [&result](const std::size_t pos) { result.emplace_back(pos); });
         return result;
     }
 
+    /**
+     * Same as above, drawing from stream 0 of a RandomStream with the given seed
+     */
+    static std::vector<std::size_t> sampleSparseErrorIidPauliNoise(const std::size_t n, const double physicalErrRate, const std::uint64_t seed) {
+        RandomStream gen(seed, 0U);
+        return sampleSparseErrorIidPauliNoise(n, physicalErrRate, gen);
+    }
+
+    /**
+     * Samples one shot of a coupled sweep over physical error rates up to maxPhysicalErrRate
+     * Each flipped qubit of an iid error at maxPhysicalErrRate gets a threshold uniform in [0, maxPhysicalErrRate),
+     * the qubits with threshold below p then form an iid error at rate p. Errors at smaller rates are thus subsets of those at larger rates.
+     * Takes O(n * maxPhysicalErrRate) expected time instead of one uniform per qubit
+     * @param n
+     * @param maxPhysicalErrRate
+     * @param gen
+     * @return pairs of threshold and qubit index, sorted by threshold
+     */
+    template <class Engine>
+    static std::vector<std::pair<double, std::size_t>> sampleCoupledErrorIidPauliNoise(const std::size_t n, const double maxPhysicalErrRate, Engine& gen) {
+        std::vector<std::pair<double, std::size_t>> result;
+        std::uniform_real_distribution<double>      threshold(0.0, std::min(maxPhysicalErrRate, 1.0));
+        forEachIidFlip(n, maxPhysicalErrRate, gen, [&](const std::size_t pos) { result.emplace_back(threshold(gen), pos); });
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    /**
+     * Samples GF2_WORD_BITS independent n-qubit iid errors at once in bit-sliced form:
+     * bit l of the j-th word is set iff qubit j is flipped in shot l.
+     * Flipped positions are found over the n x 64 grid, so the expected number of random draws is proportional to the number of flips.
+     * @param n
+     * @param physicalErrRate
+     * @param gen
+     * @return
+     */
+    template <class Engine>
+    static std::vector<gf2Word> sampleBitslicedErrorIidPauliNoise(const std::size_t n, const double physicalErrRate, Engine& gen) {
+        std::vector<gf2Word> result(n, 0U);
+        forEachIidFlip(n * GF2_WORD_BITS, physicalErrRate, gen, [&result](const std::size_t pos) {
+            result[pos / GF2_WORD_BITS] |= gf2Word{1U} << (pos % GF2_WORD_BITS);
+        });
+        return result;
+    }
+
+    /**
+     * Calls f(pos) in increasing order for the positions in [0, nrPositions) that are flipped independently with probability physicalErrRate
+     * Instead of one draw per position, the gap to the next flipped position is drawn from a geometric distribution,
+     * so only one random number is consumed per flip
+     * @param nrPositions
+     * @param physicalErrRate
+     * @param gen
+     * @param f
+     */
+    template <class Engine, class F>
+    static void forEachIidFlip(const std::size_t nrPositions, const double physicalErrRate, Engine& gen, F&& f) {
+        if (physicalErrRate <= 0.0) {
+            return;
+        }
+        if (physicalErrRate >= 1.0) {
+            for (std::size_t pos = 0; pos < nrPositions; pos++) {
+                f(pos);
+            }
+            return;
+        }
+        const auto                             logQ = std::log1p(-physicalErrRate);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        std::size_t                            pos = 0U;
+        while (pos < nrPositions) {
+            // gap until the next flip is geometric with success probability physicalErrRate
+            const auto gap = std::floor(std::log(1.0 - uniform(gen)) / logQ);
+            if (gap >= static_cast<double>(nrPositions - pos)) {
+                break;
+            }
+            pos += static_cast<std::size_t>(gap);
+            f(pos);
+            pos++;
+        }
+    }
+
+    /**
+     * Indices of the positions that are set in the given lane of a bit-sliced batch, in increasing order
+     * @param slices one word per position, bit l holds shot l
+     * @param lane
+     * @return
+     */
+    static std::vector<std::uint32_t> extractBitslicedLaneSupport(const std::vector<gf2Word>& slices, const std::size_t lane) {
+        std::vector<std::uint32_t> res;
+        for (std::size_t j = 0; j < slices.size(); j++) {
+            if (((slices[j] >> lane) & 1U) != 0U) {
+                res.emplace_back(static_cast<std::uint32_t>(j));
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Builds the bit-packed vector of length n with the given support
+     * @param n
+     * @param support
+     * @return
+     */
+    static Gf2Vector fromSupport(const std::size_t n, const std::vector<std::size_t>& support) {
+        Gf2Vector res(n);
+        for (const auto i : support) {
+            res.set(i);
+        }
+        return res;
+    }
+
+    /**
+     * Extracts a single shot from a bit-sliced batch
+     * @param slices one word per position, bit l holds shot l
+     * @param lane
+     * @return
+     */
+    static Gf2Vector extractBitslicedLane(const std::vector<gf2Word>& slices, const std::size_t lane) {
+        Gf2Vector res(slices.size());
+        for (std::size_t j = 0; j < slices.size(); j++) {
+            if (((slices[j] >> lane) & 1U) != 0U) {
+                res.set(j);
+            }
+        }
+        return res;
+    }
+
     /**
      *
      * @param error bool vector representing error
@@ -309,6 +477,15 @@ public:
         }
     }
 
+    /**
+     * Word-wise variant of computeResidualErr for bit-packed vectors
+     * @param error
+     * @param residual
+     */
+    static void computeResidualErr(const Gf2Vector& error, Gf2Vector& residual) {
+        residual ^= error;
+    }
+
     static gf2Mat importGf2MatrixFromFile(const std::string& filepath) {
         std::string   line;
         int           word; // NOLINT(cppcoreguidelines-init-variables)
@@ -4,30 +4,168 @@
 #include "DecodingSimulator.hpp"
 
 #include "DecodingRunInformation.hpp"
+#include "ParallelFor.hpp"
+#include "RandomStream.hpp"
+#include "ResultsSink.hpp"
+#include "SpaceTimeGraph.hpp"
 #include "UFDecoder.hpp"
 
-std::string generateOutFileName(const std::string& filepath) {
+#include <chrono>
+#include <cmath>
+#include <exception>
+
+std::string generateOutFileName(const std::string& filepath, const std::string& extension = ".json") {
     auto               t  = std::time(nullptr);
     auto               tm = *std::localtime(&t); // localtime might not be threadsafe. Currently irrelevant
     std::ostringstream oss;
     oss << std::put_time(&tm, "%d-%m-%Y");
     auto timestamp = oss.str();
-    return filepath + "-" + timestamp + ".json";
-}
-
-void DecodingSimulator::simulateWER(const std::string& rawDataOutputFilepath,
-                                    const std::string& statsOutputFilepath,
-                                    double             minPhysicalErrRate,
-                                    double             maxPhysicalErrRate,
-                                    std::size_t        nrRunsPerRate,
-                                    Code&              code,
-                                    const double       perStepSize,
-                                    const DecoderType& decoderType) {
-    const bool                                 rawOut   = !rawDataOutputFilepath.empty();
-    const bool                                 statsOut = !statsOutputFilepath.empty();
-    std::ofstream                              statisticsOutstr;
-    std::ofstream                              rawDataOutput;
-    std::map<std::string, double, std::less<>> wordErrRatePerPhysicalErrRate;
+    return filepath + "-" + timestamp + extension;
+}
+
+std::unique_ptr<Decoder> createDecoder(const DecoderType& decoderType) {
+    if (decoderType == DecoderType::UfDecoder) {
+        return std::make_unique<UFDecoder>();
+    }
+    if (decoderType == DecoderType::UfHeuristic) {
+        return std::make_unique<UFHeuristic>();
+    }
+    throw QeccException("Invalid DecoderType, cannot simulate");
+}
+
+/**
+ * Creates one decoder per worker thread, all sharing the same read-only code
+ */
+std::vector<std::unique_ptr<Decoder>> createDecoders(const DecoderType& decoderType, const std::shared_ptr<const Code>& code, const std::size_t nrWorkers) {
+    std::vector<std::unique_ptr<Decoder>> decoders;
+    decoders.reserve(nrWorkers);
+    for (std::size_t i = 0; i < nrWorkers; i++) {
+        decoders.emplace_back(createDecoder(decoderType));
+        decoders.back()->setCode(code);
+    }
+    return decoders;
+}
+
+std::uint64_t resolveSeed(const std::optional<std::uint64_t>& seed) {
+    if (seed.has_value()) {
+        return *seed;
+    }
+    std::random_device rd;
+    return (static_cast<std::uint64_t>(rd()) << 32U) ^ rd();
+}
+
+/**
+ * Decodes nrShots samples with each decoder before anything is measured, so that workspaces are allocated and caches are warm
+ * The warm-up draws from its own random streams and does not change the measured samples
+ */
+void warmUpDecoders(const std::vector<std::unique_ptr<Decoder>>& decoders, const Code& code, const double physicalErrRate, const std::size_t nrShots, const std::uint64_t seed) {
+    constexpr std::uint64_t WARMUP_STREAMS = std::uint64_t{1U} << 63U;
+    // one task per decoder, so every decoder is warmed up no matter which thread picks the task
+    parallelFor(decoders.size(), decoders.size(), [&](const std::size_t task, std::size_t /*worker*/) {
+        auto&        decoder = *decoders[task];
+        RandomStream gen(seed, WARMUP_STREAMS | task);
+        for (std::size_t i = 0; i < nrShots; i++) {
+            const auto flipped = Utils::sampleSparseErrorIidPauliNoise(code.getN(), physicalErrRate, gen);
+            decoder.decode(code.gethZ()->getSyndromeFromSupport(flipped).toBoolVector());
+            decoder.reset();
+        }
+    });
+}
+
+/**
+ * Writes the latency histograms as json object to a file next to the raw data
+ */
+void writeLatencies(const std::string& rawDataOutputFilepath, const std::map<std::string, LatencyHistogram, std::less<>>& histograms) {
+    auto latencyFileName = generateOutFileName(rawDataOutputFilepath, ".latency.json");
+    std::cout << "Writing latencies to " << latencyFileName << std::endl;
+    json latencies = json::object();
+    for (const auto& [key, histogram] : histograms) {
+        latencies[key] = histogram.to_json();
+    }
+    std::ofstream latencyOutput(latencyFileName);
+    latencyOutput << latencies.dump(2U);
+}
+
+/**
+ * Writes the estimates as json object keyed by the physical error rate
+ */
+void writeEstimates(const std::string& rawDataOutputFilepath, const std::vector<WerEstimate>& estimates) {
+    auto dataFileName = generateOutFileName(rawDataOutputFilepath);
+    std::cout << "Writing raw data to " << dataFileName << std::endl;
+    std::map<std::string, json, std::less<>> estimatePerPhysicalErrRate;
+    for (const auto& est : estimates) {
+        estimatePerPhysicalErrRate.try_emplace(std::to_string(est.physicalErrRate), est.to_json());
+    }
+    std::ofstream rawDataOutput(dataFileName);
+    const json    dataj = estimatePerPhysicalErrRate;
+    rawDataOutput << dataj.dump(2U);
+}
+
+/**
+ * Decodes the shots of one bit-sliced batch
+ * @param onShot called as onShot(lane, status, result, decodingNanos) for each shot in lane order, result is nullptr if the shot was not decoded
+ * @return number of failed shots
+ */
+template <class F>
+std::size_t decodeBitslicedBatch(Decoder& decoder, const Code& code, const std::vector<gf2Word>& errSlices, const std::vector<gf2Word>& syndrSlices, const std::size_t nrLanes, F&& onShot) {
+    gf2Word errLanes   = 0U;
+    gf2Word syndrLanes = 0U;
+    for (const auto w : errSlices) {
+        errLanes |= w;
+    }
+    for (const auto w : syndrSlices) {
+        syndrLanes |= w;
+    }
+    std::size_t nrOfFailedRuns = 0U;
+    for (std::size_t lane = 0; lane < nrLanes; lane++) {
+        bool                  success = true;
+        const DecodingResult* result  = nullptr;
+        std::uint64_t         nanos   = 0U;
+        if (((syndrLanes >> lane) & 1U) != 0U) {
+            decoder.reset();
+            const auto error    = Utils::extractBitslicedLane(errSlices, lane);
+            const auto syndrome = Utils::extractBitslicedLane(syndrSlices, lane);
+            const auto syndr    = syndrome.toBoolVector();
+            const auto begin    = std::chrono::steady_clock::now();
+            decoder.decode(syndr);
+            const auto end = std::chrono::steady_clock::now();
+
+            const auto& decodingResult = decoder.result;
+            auto        residualErr    = Gf2Vector(decodingResult.estimBoolVector);
+            Utils::computeResidualErr(error, residualErr);
+            success = code.isXStabilizer(residualErr);
+            result  = &decodingResult;
+            nanos   = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+        } else if (((errLanes >> lane) & 1U) != 0U) {
+            // undetectable error: the decoder would return the trivial estimate, so the error itself is the residual
+            success = code.isXStabilizer(Utils::extractBitslicedLane(errSlices, lane));
+        }
+        // lanes without error are trivially successful and skip decoding altogether
+        if (!success) {
+            nrOfFailedRuns++;
+        }
+        onShot(lane, success ? SUCCESS : FAILURE, result, nanos);
+    }
+    return nrOfFailedRuns;
+}
+
+void DecodingSimulator::simulateWER(const std::string&                  rawDataOutputFilepath,
+                                    const std::string&                  statsOutputFilepath,
+                                    double                              minPhysicalErrRate,
+                                    double                              maxPhysicalErrRate,
+                                    std::size_t                         nrRunsPerRate,
+                                    Code&                               code,
+                                    const double                        perStepSize,
+                                    const DecoderType&                  decoderType,
+                                    const std::size_t                   nrThreads,
+                                    const std::optional<std::uint64_t>& seed,
+                                    const ResultsFormat                 statsFormat) {
+    const bool                                           rawOut   = !rawDataOutputFilepath.empty();
+    const bool                                           statsOut = !statsOutputFilepath.empty();
+    std::ofstream                                        rawDataOutput;
+    std::unique_ptr<ResultsSink>                         statsSink;
+    std::map<std::string, double, std::less<>>           wordErrRatePerPhysicalErrRate;
+    std::map<std::string, LatencyHistogram, std::less<>> latencyPerPhysicalErrRate;
 
     if (rawOut) {
         auto dataFileName = generateOutFileName(rawDataOutputFilepath);
@@ -35,72 +173,652 @@ void DecodingSimulator::simulateWER(const std::string& rawDataOutputFilepath,
         std::cout << "Writing raw data to " << dataFileName << std::endl;
     }
     if (statsOut) {
-        auto jsonFileName = generateOutFileName(statsOutputFilepath);
-        statisticsOutstr.open(jsonFileName);
-        std::cout << "Writing stats output to " << jsonFileName << std::endl;
-        statisticsOutstr << "{ \"runs\" : [ ";
-        statisticsOutstr << R"({ "run": { "physicalErrRate":)" << minPhysicalErrRate << ", \"data\": [ ";
+        std::string statsFileName;
+        if (statsFormat == ResultsFormat::Columnar) {
+            statsFileName = generateOutFileName(statsOutputFilepath, ".columns");
+            statsSink     = std::make_unique<AsyncColumnarSink>(statsFileName);
+        } else {
+            statsFileName = generateOutFileName(statsOutputFilepath, ".ndjson");
+            statsSink     = std::make_unique<AsyncNdjsonSink>(statsFileName);
+        }
+        std::cout << "Writing stats output to " << statsFileName << std::endl;
     }
 
-    auto currPer = minPhysicalErrRate;
+    // derived structures of the code are built once and shared read-only by the decoders, one decoder per thread is reused for all its shots
+    const auto sharedCode = std::make_shared<const Code>(code);
+    const auto decoders   = createDecoders(decoderType, sharedCode, resolveNrThreads(nrThreads));
+    const auto baseSeed   = resolveSeed(seed);
+    const auto nrBatches  = (nrRunsPerRate + GF2_WORD_BITS - 1) / GF2_WORD_BITS;
+    // latencies are only a by-product here, a short warm-up keeps first-use allocations out of them
+    constexpr std::size_t WARMUP_SHOTS = 16U;
+    warmUpDecoders(decoders, *sharedCode, minPhysicalErrRate, WARMUP_SHOTS, baseSeed);
+
+    // per batch results, combined in batch order so that the output does not depend on the scheduling
+    std::vector<std::size_t>      failuresPerBatch(nrBatches);
+    std::vector<LatencyHistogram> latencyPerWorker(decoders.size());
+
+    auto        currPer = minPhysicalErrRate;
+    std::size_t rateIdx = 0U;
     while (currPer < maxPhysicalErrRate) {
-        auto nrOfFailedRuns = 0;
-        for (std::size_t j = 0; j < nrRunsPerRate; j++) {
-            std::unique_ptr<Decoder> decoder;
-            if (decoderType == DecoderType::UfDecoder) {
-                decoder = std::make_unique<UFDecoder>();
-            } else if (decoderType == DecoderType::UfHeuristic) {
-                decoder = std::make_unique<UFHeuristic>();
-            } else {
-                throw QeccException("Invalid DecoderType, cannot simulate");
-            }
-            decoder->setCode(code);
-            const auto error    = Utils::sampleErrorIidPauliNoise(code.getN(), currPer);
-            const auto syndrome = decoder->getCode()->getXSyndrome(error);
-            decoder->decode(syndrome);
-            const auto& decodingResult = decoder->result;
-            auto        residualErr    = decodingResult.estimBoolVector;
-            Utils::computeResidualErr(error, residualErr);
-            const auto success = decoder->getCode()->isXStabilizer(residualErr);
-
-            DecodingRunInformation stats;
-            stats.result = decoder->result;
-            if (success) {
-                stats.status = SUCCESS;
-            } else {
-                stats.status = FAILURE;
-                nrOfFailedRuns++;
-            }
-            if (statsOut) {
-                statisticsOutstr << stats.to_json().dump(2U);
-                if (j != nrRunsPerRate - 1) {
-                    statisticsOutstr << ", ";
-                }
-            }
+        // shots are sampled in bit-sliced batches, one shot per bit lane, each batch draws from its own random stream
+        parallelFor(nrBatches, decoders.size(), [&](const std::size_t batchIdx, const std::size_t worker) {
+            RandomStream gen(baseSeed, (static_cast<std::uint64_t>(rateIdx) << 32U) | batchIdx);
+            const auto   batchStart  = batchIdx * GF2_WORD_BITS;
+            const auto   nrLanes     = std::min(GF2_WORD_BITS, nrRunsPerRate - batchStart);
+            const auto   errSlices   = Utils::sampleBitslicedErrorIidPauliNoise(sharedCode->getN(), currPer, gen);
+            const auto   syndrSlices = sharedCode->gethZ()->getBitslicedSyndrome(errSlices);
+
+            failuresPerBatch[batchIdx] = decodeBitslicedBatch(*decoders[worker], *sharedCode, errSlices, syndrSlices, nrLanes,
+                                                              [&](const std::size_t lane, const DecodingResultStatus status, const DecodingResult* result, const std::uint64_t nanos) {
+                                                                  if (result != nullptr) {
+                                                                      latencyPerWorker[worker].record(nanos);
+                                                                  }
+                                                                  if (!statsOut) {
+                                                                      return;
+                                                                  }
+                                                                  // formatting and I/O are left to the writer thread
+                                                                  ShotRecord record;
+                                                                  record.physicalErrRate = currPer;
+                                                                  record.shot            = batchStart + lane;
+                                                                  record.status          = status;
+                                                                  record.error           = Utils::extractBitslicedLaneSupport(errSlices, lane);
+                                                                  record.syndrome        = Utils::extractBitslicedLaneSupport(syndrSlices, lane);
+                                                                  record.decodingNanos   = nanos;
+                                                                  if (result != nullptr) {
+                                                                      record.decodingTime = result->decodingTime;
+                                                                      for (std::size_t j = 0; j < result->estimBoolVector.size(); j++) {
+                                                                          if (result->estimBoolVector[j]) {
+                                                                              record.estimate.emplace_back(static_cast<std::uint32_t>(j));
+                                                                          }
+                                                                      }
+                                                                  }
+                                                                  statsSink->write(std::move(record));
+                                                              });
+        });
+        std::size_t nrOfFailedRuns = 0U;
+        for (const auto f : failuresPerBatch) {
+            nrOfFailedRuns += f;
         }
         // compute word error rate WER
         const auto blockErrRate = static_cast<double>(nrOfFailedRuns) / static_cast<double>(nrRunsPerRate);
         const auto wordErrRate  = blockErrRate / static_cast<double>(code.getK());       // rate of codewords re decoder does not give correct answer (fails or introduces logical operator)
         wordErrRatePerPhysicalErrRate.try_emplace(std::to_string(currPer), wordErrRate); // to string for json parsing
+        LatencyHistogram latency;
+        for (auto& workerLatency : latencyPerWorker) {
+            latency += workerLatency;
+            workerLatency = LatencyHistogram();
+        }
+        latencyPerPhysicalErrRate.try_emplace(std::to_string(currPer), std::move(latency));
 
         currPer += perStepSize;
+        rateIdx++;
     }
 
-    statisticsOutstr << "}";
+    if (statsSink) {
+        statsSink->close();
+    }
     const json dataj = wordErrRatePerPhysicalErrRate;
     rawDataOutput << dataj.dump(2U);
-    statisticsOutstr.close();
     rawDataOutput.close();
-    flint_cleanup();
+    if (rawOut) {
+        writeLatencies(rawDataOutputFilepath, latencyPerPhysicalErrRate);
+    }
 }
 
-void DecodingSimulator::simulateAverageRuntime(const std::string& rawDataOutputFilepath,
-                                               const std::string& decodingInfoOutfilePath,
-                                               const double&      physicalErrRate,
-                                               const std::size_t  nrRuns,
-                                               const std::string& codesPath,
-                                               const std::size_t  nrSamples,
-                                               const DecoderType& decoderType) {
+std::vector<WerEstimate> DecodingSimulator::simulateWERAdaptive(const std::string&                  rawDataOutputFilepath,
+                                                                 const double                        minPhysicalErrRate,
+                                                                 const double                        maxPhysicalErrRate,
+                                                                 const double                        perStepSize,
+                                                                 const Code&                         code,
+                                                                 const DecoderType&                  decoderType,
+                                                                 const StoppingCriteria&             criteria,
+                                                                 const std::size_t                   nrThreads,
+                                                                 const std::optional<std::uint64_t>& seed) {
+    if (criteria.maxShots == 0U) {
+        throw QeccException("Cannot simulate, maximum number of shots must be positive");
+    }
+    // rounds start with a single batch so that easy rates stop early, and double up to this size to keep the threads busy
+    constexpr std::size_t MAX_BATCHES_PER_ROUND = 256U;
+
+    const auto               sharedCode = std::make_shared<const Code>(code);
+    const auto               decoders   = createDecoders(decoderType, sharedCode, resolveNrThreads(nrThreads));
+    const auto               baseSeed   = resolveSeed(seed);
+    const auto               k          = static_cast<double>(code.getK());
+    std::vector<WerEstimate> estimates;
+    std::vector<std::size_t> failuresPerBatch;
+
+    auto        currPer = minPhysicalErrRate;
+    std::size_t rateIdx = 0U;
+    while (currPer < maxPhysicalErrRate) {
+        WerEstimate est;
+        est.physicalErrRate = currPer;
+
+        const auto  start     = std::chrono::steady_clock::now();
+        std::size_t batchIdx  = 0U; // batches are numbered as in simulateWER and draw from the same streams
+        std::size_t roundSize = 1U;
+        bool        stop      = false;
+        while (!stop) {
+            const auto remaining = criteria.maxShots - est.shots;
+            const auto nrBatches = std::min(roundSize, (remaining + GF2_WORD_BITS - 1) / GF2_WORD_BITS);
+            failuresPerBatch.assign(nrBatches, 0U);
+            parallelFor(nrBatches, decoders.size(), [&](const std::size_t task, const std::size_t worker) {
+                RandomStream gen(baseSeed, (static_cast<std::uint64_t>(rateIdx) << 32U) | (batchIdx + task));
+                const auto   nrLanes     = std::min(GF2_WORD_BITS, remaining - task * GF2_WORD_BITS);
+                const auto   errSlices   = Utils::sampleBitslicedErrorIidPauliNoise(sharedCode->getN(), currPer, gen);
+                const auto   syndrSlices = sharedCode->gethZ()->getBitslicedSyndrome(errSlices);
+                failuresPerBatch[task]   = decodeBitslicedBatch(*decoders[worker], *sharedCode, errSlices, syndrSlices, nrLanes,
+                                                                [](std::size_t, DecodingResultStatus, const DecodingResult*, std::uint64_t) {});
+            });
+            for (const auto f : failuresPerBatch) {
+                est.failures += f;
+            }
+            est.shots += std::min(nrBatches * GF2_WORD_BITS, remaining);
+            batchIdx += nrBatches;
+            roundSize = std::min(2 * roundSize, MAX_BATCHES_PER_ROUND);
+
+            const auto [lower, upper] = wilsonInterval(est.failures, est.shots, criteria.z);
+            const auto blockErrRate   = static_cast<double>(est.failures) / static_cast<double>(est.shots);
+            est.wordErrRate           = blockErrRate / k;
+            est.lower                 = lower / k;
+            est.upper                 = upper / k;
+            est.seconds               = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            stop = est.shots >= criteria.maxShots ||
+                   (criteria.maxSeconds > 0.0 && est.seconds >= criteria.maxSeconds) ||
+                   (criteria.targetFailures > 0U && est.failures >= criteria.targetFailures) ||
+                   (criteria.targetRelativeWidth > 0.0 && est.failures > 0U && (upper - lower) / blockErrRate <= criteria.targetRelativeWidth);
+        }
+        estimates.emplace_back(est);
+
+        currPer += perStepSize;
+        rateIdx++;
+    }
+
+    if (!rawDataOutputFilepath.empty()) {
+        writeEstimates(rawDataOutputFilepath, estimates);
+    }
+    return estimates;
+}
+
+std::vector<WerEstimate> DecodingSimulator::simulateWERCoupled(const std::string&                  rawDataOutputFilepath,
+                                                                const double                        minPhysicalErrRate,
+                                                                const double                        maxPhysicalErrRate,
+                                                                const double                        perStepSize,
+                                                                const std::size_t                   nrRunsPerRate,
+                                                                const Code&                         code,
+                                                                const DecoderType&                  decoderType,
+                                                                const std::size_t                   nrThreads,
+                                                                const std::optional<std::uint64_t>& seed) {
+    std::vector<double> rates;
+    for (auto currPer = minPhysicalErrRate; currPer < maxPhysicalErrRate; currPer += perStepSize) {
+        rates.emplace_back(currPer);
+    }
+    std::vector<WerEstimate> estimates(rates.size());
+    if (rates.empty()) {
+        return estimates;
+    }
+    const auto sharedCode = std::make_shared<const Code>(code);
+    const auto decoders   = createDecoders(decoderType, sharedCode, resolveNrThreads(nrThreads));
+    const auto baseSeed   = resolveSeed(seed);
+    const auto nrChunks   = (nrRunsPerRate + GF2_WORD_BITS - 1) / GF2_WORD_BITS;
+    const auto n          = code.getN();
+
+    // failures per rate and chunk of shots, summed in chunk order afterwards
+    std::vector<std::size_t> failures(rates.size() * nrChunks, 0U);
+    parallelFor(nrChunks, decoders.size(), [&](const std::size_t chunk, const std::size_t worker) {
+        auto&        decoder = *decoders[worker];
+        RandomStream gen(baseSeed, chunk);
+        for (std::size_t shot = chunk * GF2_WORD_BITS; shot < std::min((chunk + 1) * GF2_WORD_BITS, nrRunsPerRate); shot++) {
+            const auto  flips = Utils::sampleCoupledErrorIidPauliNoise(n, rates.back(), gen);
+            Gf2Vector   error(n);
+            Gf2Vector   syndrome(sharedCode->gethZ()->nrChecks());
+            std::size_t nextFlip = 0U;
+            bool        failed   = false;
+            for (std::size_t r = 0; r < rates.size(); r++) {
+                const auto before = nextFlip;
+                for (; nextFlip < flips.size() && flips[nextFlip].first < rates[r]; nextFlip++) {
+                    error.flip(flips[nextFlip].second);
+                    sharedCode->gethZ()->addColumnTo(flips[nextFlip].second, syndrome);
+                }
+                // decoders are deterministic, the outcome only changes if the error does
+                if (r == 0U || nextFlip != before) {
+                    auto residual = error;
+                    if (syndrome.any()) {
+                        decoder.reset();
+                        decoder.decode(syndrome.toBoolVector());
+                        Utils::computeResidualErr(Gf2Vector(decoder.result.estimBoolVector), residual);
+                    }
+                    failed = !sharedCode->isXStabilizer(residual);
+                }
+                failures[r * nrChunks + chunk] += static_cast<std::size_t>(failed);
+            }
+        }
+    });
+
+    const auto k = static_cast<double>(code.getK());
+    for (std::size_t r = 0; r < rates.size(); r++) {
+        auto& est           = estimates[r];
+        est.physicalErrRate = rates[r];
+        est.shots           = nrRunsPerRate;
+        for (std::size_t chunk = 0; chunk < nrChunks; chunk++) {
+            est.failures += failures[r * nrChunks + chunk];
+        }
+        const auto [lower, upper] = wilsonInterval(est.failures, est.shots, 1.96);
+        est.wordErrRate           = static_cast<double>(est.failures) / static_cast<double>(std::max<std::size_t>(est.shots, 1U)) / k;
+        est.lower                 = lower / k;
+        est.upper                 = upper / k;
+    }
+
+    if (!rawDataOutputFilepath.empty()) {
+        writeEstimates(rawDataOutputFilepath, estimates);
+    }
+    return estimates;
+}
+
+std::vector<WerEstimate> DecodingSimulator::simulateWERPhenomenological(const std::string&                  rawDataOutputFilepath,
+                                                                         const double                        minPhysicalErrRate,
+                                                                         const double                        maxPhysicalErrRate,
+                                                                         const double                        perStepSize,
+                                                                         const std::size_t                   nrRunsPerRate,
+                                                                         const Code&                         code,
+                                                                         const DecoderType&                  decoderType,
+                                                                         const std::size_t                   rounds,
+                                                                         const std::optional<double>&        measurementErrRate,
+                                                                         const std::size_t                   nrThreads,
+                                                                         const std::optional<std::uint64_t>& seed) {
+    if (decoderType != DecoderType::UfHeuristic) {
+        throw QeccException("Phenomenological noise is only supported by UfHeuristic");
+    }
+    std::vector<double> rates;
+    for (auto currPer = minPhysicalErrRate; currPer < maxPhysicalErrRate; currPer += perStepSize) {
+        rates.emplace_back(currPer);
+    }
+    std::vector<WerEstimate> estimates(rates.size());
+    if (rates.empty()) {
+        return estimates;
+    }
+    const auto  sharedCode = std::make_shared<const Code>(code);
+    const auto  graph      = SpaceTimeGraph(*sharedCode, rounds);
+    const auto  decoders   = createDecoders(decoderType, graph.getDecodingCode(), resolveNrThreads(nrThreads));
+    const auto  baseSeed   = resolveSeed(seed);
+    const auto  nrChunks   = (nrRunsPerRate + GF2_WORD_BITS - 1) / GF2_WORD_BITS;
+    const auto& hz         = *sharedCode->gethZ();
+    const auto  n          = hz.nrBits();
+    const auto  m          = hz.nrChecks();
+
+    for (std::size_t r = 0; r < rates.size(); r++) {
+        const auto               dataErrRate = rates[r];
+        const auto               measErrRate = measurementErrRate.value_or(dataErrRate);
+        const auto               begin       = std::chrono::steady_clock::now();
+        std::vector<std::size_t> failuresPerChunk(nrChunks, 0U);
+        parallelFor(nrChunks, decoders.size(), [&](const std::size_t chunk, const std::size_t worker) {
+            auto&                  decoder = *decoders[worker];
+            RandomStream           gen(baseSeed, (static_cast<std::uint64_t>(r) << 32U) | chunk);
+            std::vector<Gf2Vector> measured(rounds);
+            for (std::size_t shot = chunk * GF2_WORD_BITS; shot < std::min((chunk + 1) * GF2_WORD_BITS, nrRunsPerRate); shot++) {
+                // data errors accumulate over the rounds, measurement errors only affect their own round
+                Gf2Vector error(n);
+                Gf2Vector syndrome(m);
+                for (std::size_t t = 0; t < rounds; t++) {
+                    for (const auto j : Utils::sampleSparseErrorIidPauliNoise(n, dataErrRate, gen)) {
+                        error.flip(j);
+                        hz.addColumnTo(j, syndrome);
+                    }
+                    measured[t] = syndrome;
+                    if (t + 1 < rounds) {
+                        for (const auto c : Utils::sampleSparseErrorIidPauliNoise(m, measErrRate, gen)) {
+                            measured[t].flip(c);
+                        }
+                    }
+                }
+                const auto events = graph.getDetectionEvents(measured);
+                if (events.any()) {
+                    decoder.reset();
+                    decoder.decode(events.toBoolVector());
+                    Utils::computeResidualErr(graph.getDataCorrection(decoder.result.estimBoolVector), error);
+                }
+                failuresPerChunk[chunk] += static_cast<std::size_t>(!sharedCode->isXStabilizer(error));
+            }
+        });
+
+        auto& est           = estimates[r];
+        est.physicalErrRate = dataErrRate;
+        est.shots           = nrRunsPerRate;
+        for (const auto f : failuresPerChunk) {
+            est.failures += f;
+        }
+        const auto k              = static_cast<double>(code.getK());
+        const auto [lower, upper] = wilsonInterval(est.failures, est.shots, 1.96);
+        est.wordErrRate           = static_cast<double>(est.failures) / static_cast<double>(std::max<std::size_t>(est.shots, 1U)) / k;
+        est.lower                 = lower / k;
+        est.upper                 = upper / k;
+        est.seconds               = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    if (!rawDataOutputFilepath.empty()) {
+        writeEstimates(rawDataOutputFilepath, estimates);
+    }
+    return estimates;
+}
+
+DecoderComparison DecodingSimulator::compareDecoders(const std::string&                  rawDataOutputFilepath,
+                                                     const double                        physicalErrRate,
+                                                     const std::size_t                   nrShots,
+                                                     const Code&                         code,
+                                                     const std::vector<DecoderConfig>&   configs,
+                                                     const std::size_t                   nrThreads,
+                                                     const std::optional<std::uint64_t>& seed) {
+    const auto sharedCode = std::make_shared<const Code>(code);
+    const auto nrConfigs  = configs.size();
+    const auto nrWorkers  = resolveNrThreads(nrThreads);
+    const auto baseSeed   = resolveSeed(seed);
+    const auto nrBatches  = (nrShots + GF2_WORD_BITS - 1) / GF2_WORD_BITS;
+
+    DecoderComparison res;
+    res.physicalErrRate = physicalErrRate;
+    res.shots           = nrShots;
+    res.configs         = configs;
+    res.failures.assign(nrConfigs, 0U);
+    res.decodingNanos.assign(nrConfigs, 0U);
+    res.onlyFailed.assign(nrConfigs, std::vector<std::size_t>(nrConfigs, 0U));
+    // one decoder per configuration and statistics per worker, the counts are sums and hence independent of the scheduling
+    std::vector<std::vector<std::unique_ptr<Decoder>>> decoders(nrWorkers);
+    std::vector<DecoderComparison>                     partial(nrWorkers, res);
+    for (auto& workerDecoders : decoders) {
+        for (const auto& config : configs) {
+            workerDecoders.emplace_back(createDecoder(config.decoderType));
+            workerDecoders.back()->setCode(sharedCode);
+        }
+    }
+
+    parallelFor(nrBatches, nrWorkers, [&](const std::size_t batchIdx, const std::size_t worker) {
+        auto&        stats = partial[worker];
+        RandomStream gen(baseSeed, batchIdx);
+        const auto   nrLanes     = std::min(GF2_WORD_BITS, nrShots - batchIdx * GF2_WORD_BITS);
+        const auto   errSlices   = Utils::sampleBitslicedErrorIidPauliNoise(sharedCode->getN(), physicalErrRate, gen);
+        const auto   syndrSlices = sharedCode->gethZ()->getBitslicedSyndrome(errSlices);
+
+        std::vector<bool> failed(nrConfigs);
+        for (std::size_t lane = 0; lane < nrLanes; lane++) {
+            const auto error    = Utils::extractBitslicedLane(errSlices, lane);
+            const auto syndrome = Utils::extractBitslicedLane(syndrSlices, lane);
+            if (syndrome.none()) {
+                // no decoder changes the error, all configurations agree
+                if (error.any() && !sharedCode->isXStabilizer(error)) {
+                    for (std::size_t c = 0; c < nrConfigs; c++) {
+                        stats.failures[c]++;
+                    }
+                }
+                continue;
+            }
+            stats.decoded++;
+            const auto syndr = syndrome.toBoolVector();
+            for (std::size_t c = 0; c < nrConfigs; c++) {
+                auto& decoder = *decoders[worker][c];
+                decoder.reset();
+                decoder.setGrowth(configs[c].growth);
+                const auto begin = std::chrono::steady_clock::now();
+                decoder.decode(syndr);
+                const auto end = std::chrono::steady_clock::now();
+                stats.decodingNanos[c] += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+
+                auto residual = Gf2Vector(decoder.result.estimBoolVector);
+                Utils::computeResidualErr(error, residual);
+                failed[c] = !sharedCode->isXStabilizer(residual);
+                stats.failures[c] += static_cast<std::size_t>(failed[c]);
+            }
+            for (std::size_t i = 0; i < nrConfigs; i++) {
+                for (std::size_t j = 0; j < nrConfigs; j++) {
+                    stats.onlyFailed[i][j] += static_cast<std::size_t>(failed[i] && !failed[j]);
+                }
+            }
+        }
+    });
+
+    for (const auto& stats : partial) {
+        res.decoded += stats.decoded;
+        for (std::size_t i = 0; i < nrConfigs; i++) {
+            res.failures[i] += stats.failures[i];
+            res.decodingNanos[i] += stats.decodingNanos[i];
+            for (std::size_t j = 0; j < nrConfigs; j++) {
+                res.onlyFailed[i][j] += stats.onlyFailed[i][j];
+            }
+        }
+    }
+
+    if (!rawDataOutputFilepath.empty()) {
+        auto dataFileName = generateOutFileName(rawDataOutputFilepath);
+        std::cout << "Writing raw data to " << dataFileName << std::endl;
+        std::ofstream rawDataOutput(dataFileName);
+        rawDataOutput << res.to_json().dump(2U);
+    }
+    return res;
+}
+
+std::pair<double, double> DecodingSimulator::wilsonInterval(const std::size_t failures, const std::size_t shots, const double z) {
+    if (shots == 0U) {
+        return {0.0, 1.0};
+    }
+    const auto n      = static_cast<double>(shots);
+    const auto phat   = static_cast<double>(failures) / n;
+    const auto z2     = z * z;
+    const auto denom  = 1.0 + z2 / n;
+    const auto center = (phat + z2 / (2.0 * n)) / denom;
+    const auto half   = z / denom * std::sqrt(phat * (1.0 - phat) / n + z2 / (4.0 * n * n));
+    return {std::max(0.0, center - half), std::min(1.0, center + half)};
+}
+
+/**
+ * Decodes the X-error with the given support
+ * @return true if the residual error is not a stabilizer
+ */
+bool decodeSupportFails(Decoder& decoder, const Code& code, const std::vector<std::size_t>& support) {
+    const auto syndrome = code.gethZ()->getSyndromeFromSupport(support);
+    auto       residual = Utils::fromSupport(code.getN(), support);
+    if (syndrome.any()) {
+        decoder.reset();
+        decoder.decode(syndrome.toBoolVector());
+        Utils::computeResidualErr(Gf2Vector(decoder.result.estimBoolVector), residual);
+    }
+    return !code.isXStabilizer(residual);
+}
+
+/**
+ * C(n, w), saturated at cap + 1 so that it does not overflow for large n
+ */
+std::size_t binomialCapped(const std::size_t n, const std::size_t w, const std::size_t cap) {
+    if (w > n) {
+        return 0U;
+    }
+    std::size_t res = 1U;
+    for (std::size_t i = 1; i <= std::min(w, n - w); i++) {
+        // res * (n - i + 1) / i is exact since res = C(n, i - 1) after the previous step
+        res = res * (n - std::min(w, n - w) + i) / i;
+        if (res > cap) {
+            return cap + 1U;
+        }
+    }
+    return res;
+}
+
+/**
+ * The combination of w out of n elements with the given rank in lexicographic order
+ */
+std::vector<std::size_t> unrankCombination(const std::size_t n, const std::size_t w, std::size_t rank) {
+    std::vector<std::size_t> comb;
+    comb.reserve(w);
+    std::size_t c = 0U;
+    for (std::size_t i = 0; i < w; i++) {
+        // number of combinations that continue with c at position i
+        for (auto count = binomialCapped(n - c - 1, w - i - 1, rank); rank >= count; count = binomialCapped(n - c - 1, w - i - 1, rank)) {
+            rank -= count;
+            c++;
+        }
+        comb.emplace_back(c++);
+    }
+    return comb;
+}
+
+/**
+ * Advances to the next combination in lexicographic order
+ * @return false if comb was the last combination
+ */
+bool nextCombination(std::vector<std::size_t>& comb, const std::size_t n) {
+    const auto w = comb.size();
+    for (auto i = w; i-- > 0;) {
+        if (comb[i] < n - w + i) {
+            comb[i]++;
+            for (auto j = i + 1; j < w; j++) {
+                comb[j] = comb[j - 1] + 1;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Uniformly random w-subset of {0, ..., n-1} using Floyd's algorithm, w draws and no O(n) initialization
+ */
+std::vector<std::size_t> sampleFixedWeightSupport(const std::size_t n, const std::size_t w, RandomStream& gen) {
+    std::vector<std::size_t> support;
+    support.reserve(w);
+    for (auto j = n - w; j < n; j++) {
+        std::uniform_int_distribution<std::size_t> d(0U, j);
+        const auto                                 t = d(gen);
+        if (std::find(support.begin(), support.end(), t) == support.end()) {
+            support.emplace_back(t);
+        } else {
+            support.emplace_back(j);
+        }
+    }
+    return support;
+}
+
+WeightStrata DecodingSimulator::simulateWERStratified(const std::string&                  rawDataOutputFilepath,
+                                                      const std::vector<double>&          physicalErrRates,
+                                                      const Code&                         code,
+                                                      const DecoderType&                  decoderType,
+                                                      const std::size_t                   maxWeight,
+                                                      const std::size_t                   shotsPerWeight,
+                                                      const std::size_t                   enumerationLimit,
+                                                      const std::size_t                   nrThreads,
+                                                      const std::optional<std::uint64_t>& seed) {
+    // enumerated errors and sampled shots are distributed over the threads in chunks of this size
+    constexpr std::size_t CHUNK_SIZE = 64U;
+
+    const auto               sharedCode = std::make_shared<const Code>(code);
+    const auto               decoders   = createDecoders(decoderType, sharedCode, resolveNrThreads(nrThreads));
+    const auto               baseSeed   = resolveSeed(seed);
+    const auto               n          = code.getN();
+    std::vector<std::size_t> failuresPerChunk;
+
+    WeightStrata res;
+    res.n = n;
+    res.k = code.getK();
+    for (std::size_t w = 0; w <= std::min(maxWeight, n); w++) {
+        WeightStratum stratum;
+        stratum.weight = w;
+
+        const auto nrErrors = binomialCapped(n, w, enumerationLimit);
+        if (w == 0U) {
+            // the trivial error is always corrected
+            stratum.shots = 1U;
+            stratum.exact = true;
+        } else if (nrErrors <= enumerationLimit) {
+            const auto nrChunks = (nrErrors + CHUNK_SIZE - 1) / CHUNK_SIZE;
+            failuresPerChunk.assign(nrChunks, 0U);
+            parallelFor(nrChunks, decoders.size(), [&](const std::size_t chunk, const std::size_t worker) {
+                auto comb = unrankCombination(n, w, chunk * CHUNK_SIZE);
+                for (std::size_t i = 0; i < std::min(CHUNK_SIZE, nrErrors - chunk * CHUNK_SIZE); i++) {
+                    failuresPerChunk[chunk] += static_cast<std::size_t>(decodeSupportFails(*decoders[worker], *sharedCode, comb));
+                    nextCombination(comb, n);
+                }
+            });
+            stratum.shots = nrErrors;
+            stratum.exact = true;
+        } else {
+            const auto nrChunks = (shotsPerWeight + CHUNK_SIZE - 1) / CHUNK_SIZE;
+            failuresPerChunk.assign(nrChunks, 0U);
+            parallelFor(nrChunks, decoders.size(), [&](const std::size_t chunk, const std::size_t worker) {
+                RandomStream gen(baseSeed, (static_cast<std::uint64_t>(w) << 32U) | chunk);
+                for (std::size_t i = 0; i < std::min(CHUNK_SIZE, shotsPerWeight - chunk * CHUNK_SIZE); i++) {
+                    const auto support = sampleFixedWeightSupport(n, w, gen);
+                    failuresPerChunk[chunk] += static_cast<std::size_t>(decodeSupportFails(*decoders[worker], *sharedCode, support));
+                }
+            });
+            stratum.shots = shotsPerWeight;
+        }
+        for (const auto f : failuresPerChunk) {
+            stratum.failures += f;
+        }
+        failuresPerChunk.clear();
+        res.strata.emplace_back(stratum);
+    }
+
+    if (!rawDataOutputFilepath.empty()) {
+        auto dataFileName = generateOutFileName(rawDataOutputFilepath);
+        std::cout << "Writing raw data to " << dataFileName << std::endl;
+        std::map<std::string, json, std::less<>> estimatePerPhysicalErrRate;
+        for (const auto p : physicalErrRates) {
+            estimatePerPhysicalErrRate.try_emplace(std::to_string(p), res.estimate(p).to_json());
+        }
+        std::ofstream rawDataOutput(dataFileName);
+        const json    dataj = {{"strata", res.to_json()}, {"estimates", estimatePerPhysicalErrRate}};
+        rawDataOutput << dataj.dump(2U);
+    }
+    return res;
+}
+
+WerEstimate WeightStrata::estimate(const double physicalErrRate, const double z) const {
+    WerEstimate est;
+    est.physicalErrRate = physicalErrRate;
+
+    double blockErrRate = 0.0;
+    double lower        = 0.0;
+    double upper        = 0.0;
+    double mass         = 0.0;
+    for (const auto& s : strata) {
+        est.shots += s.shots;
+        est.failures += s.failures;
+        const auto b = binomialWeight(s.weight, physicalErrRate);
+        const auto f = s.shots == 0U ? 0.0 : static_cast<double>(s.failures) / static_cast<double>(s.shots);
+        mass += b;
+        blockErrRate += b * f;
+        if (s.exact) {
+            lower += b * f;
+            upper += b * f;
+        } else {
+            const auto [lo, hi] = DecodingSimulator::wilsonInterval(s.failures, s.shots, z);
+            lower += b * lo;
+            upper += b * hi;
+        }
+    }
+    if (!strata.empty() && strata.back().weight < n) {
+        // weights above the largest stratum were not sampled
+        const auto& largest  = strata.back();
+        const auto  tail     = std::max(0.0, 1.0 - mass);
+        const auto  fLargest = largest.shots == 0U ? 0.0 : static_cast<double>(largest.failures) / static_cast<double>(largest.shots);
+        blockErrRate += tail * fLargest;
+        upper += tail;
+    }
+    const auto kd   = static_cast<double>(k);
+    est.wordErrRate = std::min(1.0, blockErrRate) / kd;
+    est.lower       = std::min(1.0, lower) / kd;
+    est.upper       = std::min(1.0, upper) / kd;
+    return est;
+}
+
+std::map<std::string, LatencyHistogram> DecodingSimulator::simulateAverageRuntime(const std::string&                  rawDataOutputFilepath,
+                                                                                  const std::string&                  decodingInfoOutfilePath,
+                                                                                  const double&                       physicalErrRate,
+                                                                                  const std::size_t                   nrRuns,
+                                                                                  const std::string&                  codesPath,
+                                                                                  const std::size_t                   nrSamples,
+                                                                                  const DecoderType&                  decoderType,
+                                                                                  const std::size_t                   nrThreads,
+                                                                                  const std::optional<std::uint64_t>& seed,
+                                                                                  const std::size_t                   nrWarmupShots) {
     const bool    rawOut  = !rawDataOutputFilepath.empty();
     const bool    infoOut = !decodingInfoOutfilePath.empty();
     std::ofstream finalRawOut;
@@ -118,46 +836,63 @@ void DecodingSimulator::simulateAverageRuntime(const std::string& rawDataOutputF
         dataOutStream.rdbuf()->pubsetbuf(nullptr, 0);
     }
 
-    std::vector<std::string>                                               codePaths{};
-    std::map<std::string, std::size_t, std::less<>>                        avgSampleRuns;
-    std::map<std::string, std::map<std::string, std::size_t, std::less<>>> avgSampleRunsPerCode;
+    std::vector<std::string>                                          codePaths{};
+    std::map<std::string, double, std::less<>>                        avgSampleRuns;
+    std::map<std::string, std::map<std::string, double, std::less<>>> avgSampleRunsPerCode;
+    std::map<std::string, LatencyHistogram, std::less<>>              latencyPerCode;
 
-    DecodingRunInformation info;
     for (const auto& file : std::filesystem::directory_iterator(codesPath)) {
         codePaths.emplace_back(file.path());
     }
+    const auto nrWorkers = resolveNrThreads(nrThreads);
+    const auto baseSeed  = resolveSeed(seed);
+    const auto nrTasks   = nrRuns * nrSamples;
     try {
-        for (const auto& currPath : codePaths) {
-            std::size_t avgDecodingTimeAcc = 0U;
-            auto        code               = Code(currPath);
-            const auto  codeN              = code.getN();
+        for (std::size_t codeIdx = 0; codeIdx < codePaths.size(); codeIdx++) {
+            const auto& currPath = codePaths[codeIdx];
+            const auto  code     = std::make_shared<const Code>(currPath);
+            const auto  codeN    = code->getN();
+            const auto  decoders = createDecoders(decoderType, code, nrWorkers);
+            warmUpDecoders(decoders, *code, physicalErrRate, nrWarmupShots, baseSeed);
+            // sample i of run j is task j * nrSamples + i and draws from its own random stream
+            std::vector<std::uint64_t>          decodingTimes(nrTasks); // in ns
+            std::vector<DecodingRunInformation> infos(infoOut ? nrTasks : 0U);
+            std::vector<LatencyHistogram>       latencyPerWorker(decoders.size());
+            parallelFor(nrTasks, decoders.size(), [&](const std::size_t task, const std::size_t worker) {
+                auto&        decoder = *decoders[worker];
+                RandomStream gen(baseSeed, (static_cast<std::uint64_t>(codeIdx) << 32U) | task);
+                const auto   flipped  = Utils::sampleSparseErrorIidPauliNoise(codeN, physicalErrRate, gen);
+                const auto   syndrome = code->gethZ()->getSyndromeFromSupport(flipped).toBoolVector();
+                decoder.decode(syndrome);
+                auto const& decodingResult = decoder.result;
+                if (infoOut) {
+                    auto& info        = infos[task];
+                    info.result       = decodingResult;
+                    info.physicalErrR = physicalErrRate;
+                    info.codeSize     = codeN;
+                    info.syndrome     = syndrome;
+                    info.error        = Utils::fromSupport(codeN, flipped).toBoolVector();
+                }
+                decodingTimes[task] = decodingResult.decodingNanos;
+                latencyPerWorker[worker].record(decodingResult.decodingNanos);
+                decoder.reset();
+            });
+            LatencyHistogram latency;
+            for (const auto& workerLatency : latencyPerWorker) {
+                latency += workerLatency;
+            }
+            latencyPerCode.try_emplace(currPath, std::move(latency));
+            for (const auto& info : infos) {
+                info.print();
+            }
+            // averaging in ns, the per-decode ms values are mostly truncated to 0
+            constexpr double NANOS_PER_MILLI = 1e6;
             for (std::size_t j = 0; j < nrRuns; j++) {
+                std::uint64_t avgDecodingTimeAcc = 0U;
                 for (std::size_t i = 0; i < nrSamples; i++) {
-                    std::unique_ptr<Decoder> decoder;
-                    if (decoderType == DecoderType::UfDecoder) {
-                        decoder = std::make_unique<UFDecoder>();
-                    } else if (decoderType == DecoderType::UfHeuristic) {
-                        decoder = std::make_unique<UFHeuristic>();
-                    } else {
-                        throw QeccException("Invalid DecoderType, cannot simulate");
-                    }
-                    decoder->setCode(code);
-                    auto error    = Utils::sampleErrorIidPauliNoise(codeN, physicalErrRate);
-                    auto syndrome = code.getXSyndrome(error);
-                    decoder->decode(syndrome);
-                    auto const& decodingResult = decoder->result;
-                    if (infoOut) {
-                        info.result       = decodingResult;
-                        info.physicalErrR = physicalErrRate;
-                        info.codeSize     = codeN;
-                        info.syndrome     = syndrome;
-                        info.error        = error;
-                        info.print();
-                    }
-                    avgDecodingTimeAcc = avgDecodingTimeAcc + decodingResult.decodingTime;
-                    decoder->reset();
+                    avgDecodingTimeAcc += decodingTimes[j * nrSamples + i];
                 }
-                auto average = avgDecodingTimeAcc / nrSamples;
+                const auto average = static_cast<double>(avgDecodingTimeAcc) / static_cast<double>(nrSamples) / NANOS_PER_MILLI;
                 avgSampleRuns.try_emplace(std::to_string(j), average);
             }
             avgSampleRunsPerCode.try_emplace(currPath, avgSampleRuns);
@@ -170,7 +905,8 @@ void DecodingSimulator::simulateAverageRuntime(const std::string& rawDataOutputF
         const json j = avgSampleRunsPerCode;
         finalRawOut << j.dump(2U);
         finalRawOut.close();
+        writeLatencies(rawDataOutputFilepath, latencyPerCode);
     }
-    flint_cleanup();
     dataOutStream.close();
+    return {latencyPerCode.begin(), latencyPerCode.end()};
 }
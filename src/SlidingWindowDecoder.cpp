@@ -0,0 +1,127 @@
+#include "SlidingWindowDecoder.hpp"
+
+#include <chrono>
+
+SlidingWindowDecoder::SlidingWindowDecoder(std::shared_ptr<const Code> c, const std::size_t window, const std::size_t commit) : code(std::move(c)),
+                                                                                                                              n(code->gethZ()->nrBits()),
+                                                                                                                              m(code->gethZ()->nrChecks()),
+                                                                                                                              windowRounds(window),
+                                                                                                                              commitRounds(commit),
+                                                                                                                              windowGraph(*code, window, false),
+                                                                                                                              lastSyndrome(m),
+                                                                                                                              carry(m),
+                                                                                                                              correction(n) {
+    if (commitRounds == 0U || commitRounds > windowRounds) {
+        throw QeccException("Sliding window needs to commit between one round and the window size");
+    }
+    windowDecoder.setCode(windowGraph.getDecodingCode());
+    finalGraphs.resize(windowRounds);
+}
+
+void SlidingWindowDecoder::setGrowth(const GrowthVariant g) {
+    growth = g;
+}
+
+void SlidingWindowDecoder::setErrorRates(const double dataErrRate, const double measurementErrRate) {
+    windowDecoder.setErrorProbabilities(windowGraph.getErrorProbabilities(dataErrRate, measurementErrRate));
+    errorRates = std::make_pair(dataErrRate, measurementErrRate);
+}
+
+std::size_t SlidingWindowDecoder::pushRound(const gf2Vec& syndrome) {
+    if (finished) {
+        throw QeccException("Cannot push round, stream is finished");
+    }
+    bufferRound(syndrome);
+    if (detectors.size() < windowRounds) {
+        return 0U;
+    }
+    return decodeBuffered(windowGraph, windowDecoder, commitRounds);
+}
+
+std::size_t SlidingWindowDecoder::finish(const gf2Vec& finalSyndrome) {
+    if (finished) {
+        throw QeccException("Cannot finish stream twice");
+    }
+    bufferRound(finalSyndrome);
+    // at most W rounds are buffered, the window is decoded as soon as it is full
+    const auto rounds = detectors.size();
+    auto&      graph  = finalGraphs[rounds - 1];
+    if (graph == nullptr) {
+        graph = std::make_unique<SpaceTimeGraph>(*code, rounds);
+    }
+    finalDecoder.setCode(graph->getDecodingCode());
+    if (errorRates.has_value()) {
+        finalDecoder.setErrorProbabilities(graph->getErrorProbabilities(errorRates->first, errorRates->second));
+    }
+    finished = true;
+    return decodeBuffered(*graph, finalDecoder, rounds);
+}
+
+void SlidingWindowDecoder::reset() {
+    detectors.clear();
+    lastSyndrome.clear();
+    carry.clear();
+    correction.clear();
+    committedRounds = 0U;
+    finished        = false;
+}
+
+/**
+ * Appends the detection events of the next round, including those flipped by committed measurement errors
+ */
+void SlidingWindowDecoder::bufferRound(const gf2Vec& syndrome) {
+    if (syndrome.size() != m) {
+        throw QeccException("Cannot push round, syndrome has wrong size");
+    }
+    Gf2Vector measured(syndrome);
+    auto      events = measured;
+    events ^= lastSyndrome;
+    events ^= carry;
+    lastSyndrome = std::move(measured);
+    carry.clear();
+    detectors.emplace_back(std::move(events));
+}
+
+/**
+ * Decodes all buffered rounds on the given graph and commits the oldest ones
+ * @param graph space-time graph of the buffered rounds
+ * @param decoder decoder set to the graph
+ * @param nrCommit number of oldest rounds whose corrections are committed
+ * @return nrCommit
+ */
+std::size_t SlidingWindowDecoder::decodeBuffered(const SpaceTimeGraph& graph, UFHeuristic& decoder, const std::size_t nrCommit) {
+    const auto begin = std::chrono::steady_clock::now();
+    Gf2Vector  events(detectors.size() * m);
+    for (std::size_t t = 0; t < detectors.size(); t++) {
+        detectors[t].forEachSetBit([&](const std::size_t c) { events.set(t * m + c); });
+    }
+    if (events.any()) {
+        decoder.reset();
+        decoder.setGrowth(growth);
+        decoder.decode(events.toBoolVector());
+        const auto& estimate = decoder.result.estimBoolVector;
+        for (std::size_t t = 0; t < nrCommit; t++) {
+            for (std::size_t b = 0; b < n; b++) {
+                if (estimate[graph.dataBit(t, b)]) {
+                    correction.flip(b);
+                }
+            }
+        }
+        // the boundary between committed and buffered rounds is crossed by wrong measurements of the last committed round only
+        if (nrCommit <= graph.getMeasurementRounds()) {
+            for (std::size_t c = 0; c < m; c++) {
+                if (estimate[graph.measurementBit(nrCommit - 1, c)]) {
+                    carry.flip(c);
+                }
+            }
+        }
+    }
+    detectors.erase(detectors.begin(), detectors.begin() + static_cast<std::int64_t>(nrCommit));
+    if (!detectors.empty()) {
+        detectors.front() ^= carry;
+        carry.clear();
+    }
+    committedRounds += nrCommit;
+    windowLatencies.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count()));
+    return nrCommit;
+}
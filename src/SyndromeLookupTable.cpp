@@ -0,0 +1,350 @@
+#include "SyndromeLookupTable.hpp"
+
+#include "ParallelFor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+namespace {
+constexpr std::array<char, 8> MAGIC     = {'Q', 'E', 'C', 'C', 'L', 'U', 'T', '\0'};
+constexpr std::uint64_t       HASH_SEED = 0xCBF29CE484222325U;
+constexpr std::uint64_t       HASH_MULT = 0x9E3779B97F4A7C15U;
+
+std::uint64_t mixIndex(std::uint64_t h, const std::uint64_t idx) {
+    h ^= idx + 1U;
+    h *= HASH_MULT;
+    return h ^ (h >> 29U);
+}
+
+/**
+ * Key of a syndrome from the hash of its check indices in increasing order, never 0 which marks empty slots
+ */
+std::uint64_t syndromeKey(std::uint64_t h, const std::size_t weight) {
+    h ^= weight;
+    h *= 0xBF58476D1CE4E5B9U;
+    h ^= h >> 31U;
+    return h == 0U ? 1U : h;
+}
+
+double nChooseK(const std::size_t n, const std::size_t k) {
+    double res = 1.0;
+    for (std::size_t i = 0; i < k; i++) {
+        res = res * static_cast<double>(n - i) / static_cast<double>(i + 1);
+    }
+    return res;
+}
+
+/**
+ * Number of slots for the given number of entries, a power of two keeping the load factor below 1/2
+ */
+double capacityFor(const double nrEntries) {
+    return std::exp2(std::ceil(std::log2(std::max(1.0, 2.0 * nrEntries))));
+}
+
+/**
+ * Enumerates the errors of the given weight extending the first depth bits, in lexicographic order
+ * @param syndromes syndromes[d] is the sparse syndrome of the first d bits
+ */
+void enumerateErrors(const std::vector<std::vector<std::uint32_t>>& columns, std::vector<std::uint32_t>& bits,
+                     std::vector<std::vector<std::uint32_t>>& syndromes, const std::size_t depth,
+                     std::vector<std::uint64_t>& outKeys, std::vector<std::uint32_t>& outBits) {
+    const auto weight = bits.size();
+    if (depth == weight) {
+        const auto& syndr = syndromes[depth];
+        if (syndr.empty()) {
+            return; // undetectable, nothing to correct
+        }
+        auto h = HASH_SEED;
+        for (const auto c : syndr) {
+            h = mixIndex(h, c);
+        }
+        outKeys.emplace_back(syndromeKey(h, syndr.size()));
+        outBits.insert(outBits.end(), bits.begin(), bits.end());
+        return;
+    }
+    for (std::size_t b = bits[depth - 1] + 1U; b + (weight - depth) <= columns.size(); b++) {
+        bits[depth] = static_cast<std::uint32_t>(b);
+        syndromes[depth + 1].clear();
+        std::set_symmetric_difference(syndromes[depth].begin(), syndromes[depth].end(), columns[b].begin(), columns[b].end(),
+                                      std::back_inserter(syndromes[depth + 1]));
+        enumerateErrors(columns, bits, syndromes, depth + 1, outKeys, outBits);
+    }
+}
+
+template <class T>
+void writeValue(std::ofstream& out, const T value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+template <class T>
+T readValue(std::ifstream& in) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    T value{};
+    in.read(reinterpret_cast<char*>(&value), sizeof(T)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    return value;
+}
+
+template <class T>
+void writeArray(std::ofstream& out, const std::vector<T>& values) {
+    writeValue(out, static_cast<std::uint64_t>(values.size()));
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T))); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+template <class T>
+std::vector<T> readArray(std::ifstream& in, const std::uint64_t maxSize) {
+    const auto size = readValue<std::uint64_t>(in);
+    if (!in || size > maxSize) {
+        throw QeccException("Cannot read lookup table, file is corrupt");
+    }
+    std::vector<T> values(size);
+    in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(size * sizeof(T))); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    return values;
+}
+} // namespace
+
+SyndromeLookupTable::SyndromeLookupTable(const ParityCheckMatrix& pcm, const LookupTableConfig& config) : nrBits(pcm.nrBits()),
+                                                                                                          nrChecks(pcm.nrChecks()),
+                                                                                                          pcmFingerprint(fingerprint(pcm)),
+                                                                                                          requestedWeight(config.maxWeight),
+                                                                                                          requestedBytes(config.maxBytes) {
+    // the largest weight whose table and build buffers fit into the budget, the exact number of entries is only known after the build
+    while (maxWeight < std::min(config.maxWeight, nrBits) && tableBytes(nrBits, maxWeight + 1) <= static_cast<double>(config.maxBytes)) {
+        maxWeight++;
+    }
+    if (maxWeight == 0U) {
+        return;
+    }
+    std::vector<std::vector<std::uint32_t>> columns(nrBits);
+    std::size_t                             maxDegree = 0U;
+    for (std::size_t b = 0; b < nrBits; b++) {
+        for (const auto c : pcm.getNbrs(b)) {
+            columns[b].emplace_back(static_cast<std::uint32_t>(c - nrBits));
+        }
+        std::sort(columns[b].begin(), columns[b].end());
+        maxDegree = std::max(maxDegree, columns[b].size());
+    }
+    maxSyndromeWeight = maxWeight * maxDegree;
+
+    double bound = 0.0;
+    for (std::size_t w = 1; w <= maxWeight; w++) {
+        bound += nChooseK(nrBits, w);
+    }
+    keys.assign(static_cast<std::size_t>(capacityFor(bound)), 0U);
+    entries.assign(keys.size(), 0U);
+
+    // errors of one weight are enumerated in parallel, one task per first bit, and inserted in lexicographic order
+    const auto nrWorkers = resolveNrThreads(config.nrThreads);
+    for (std::size_t weight = 1; weight <= maxWeight; weight++) {
+        const auto                              nrTasks = nrBits - weight + 1;
+        std::vector<std::vector<std::uint64_t>> taskKeys(nrTasks);
+        std::vector<std::vector<std::uint32_t>> taskBits(nrTasks);
+        parallelFor(nrTasks, nrWorkers, [&](const std::size_t task, const std::size_t) {
+            std::vector<std::uint32_t>              bits(weight);
+            std::vector<std::vector<std::uint32_t>> syndromes(weight + 1);
+            bits[0]      = static_cast<std::uint32_t>(task);
+            syndromes[1] = columns[task];
+            enumerateErrors(columns, bits, syndromes, 1U, taskKeys[task], taskBits[task]);
+        });
+        for (std::size_t task = 0; task < nrTasks; task++) {
+            for (std::size_t i = 0; i < taskKeys[task].size(); i++) {
+                insert(taskKeys[task][i], &taskBits[task][i * weight], weight);
+            }
+            taskKeys[task] = {};
+            taskBits[task] = {};
+        }
+    }
+}
+
+/**
+ * Approximate memory in bytes of a table of all errors up to the given weight, including the buffers of the largest weight while building
+ */
+double SyndromeLookupTable::tableBytes(const std::size_t bits, const std::size_t weight) {
+    double nrErrors   = 0.0;
+    double correction = 0.0;
+    double build      = 0.0;
+    for (std::size_t w = 1; w <= weight; w++) {
+        const auto count = nChooseK(bits, w);
+        nrErrors += count;
+        correction += count * static_cast<double>(w + 1) * sizeof(std::uint32_t);
+        build = std::max(build, count * static_cast<double>(sizeof(std::uint64_t) + w * sizeof(std::uint32_t)));
+    }
+    const auto slots = capacityFor(nrErrors);
+    return slots * static_cast<double>(sizeof(std::uint64_t) + sizeof(std::uint32_t)) + correction + build;
+}
+
+void SyndromeLookupTable::insert(const std::uint64_t key, const std::uint32_t* bits, const std::size_t weight) {
+    const auto mask = keys.size() - 1;
+    auto       slot = key & mask;
+    while (keys[slot] != 0U) {
+        if (keys[slot] == key) {
+            return; // same syndrome with a lighter or lexicographically smaller error, or a hash collision caught by lookup
+        }
+        slot = (slot + 1) & mask;
+    }
+    if (corrections.size() + weight + 1 > std::numeric_limits<std::uint32_t>::max()) {
+        throw QeccException("Lookup table too large for 32-bit offsets");
+    }
+    keys[slot]    = key;
+    entries[slot] = static_cast<std::uint32_t>(corrections.size());
+    corrections.emplace_back(static_cast<std::uint32_t>(weight));
+    corrections.insert(corrections.end(), bits, bits + weight); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    nrEntries++;
+}
+
+bool SyndromeLookupTable::lookup(const Gf2Vector& syndrome, const ParityCheckMatrix& pcm, std::vector<std::size_t>& correction) const {
+    if (syndrome.size() != nrChecks || pcm.nrBits() != nrBits) {
+        throw QeccException("Cannot look up syndrome, table was built for another code");
+    }
+    if (keys.empty()) {
+        return false;
+    }
+    auto        h      = HASH_SEED;
+    std::size_t weight = 0U;
+    syndrome.forEachSetBit([&](const std::size_t c) {
+        h = mixIndex(h, c);
+        weight++;
+    });
+    if (weight == 0U || weight > maxSyndromeWeight) {
+        return false;
+    }
+    const auto key  = syndromeKey(h, weight);
+    const auto mask = keys.size() - 1;
+    auto       slot = key & mask;
+    while (keys[slot] != key) {
+        if (keys[slot] == 0U) {
+            return false;
+        }
+        slot = (slot + 1) & mask;
+    }
+    const auto* corr   = &corrections[entries[slot]];
+    const auto  nrFlip = static_cast<std::size_t>(corr[0]);
+    const auto* flips  = corr + 1; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    // the syndrome of the correction has to be the given one, each check is counted at the first flipped bit it is adjacent to
+    const auto  isAdjacent = [&](const std::size_t bit, const std::size_t check) {
+        const auto nbrs = pcm.getNbrs(bit);
+        return std::find(nbrs.begin(), nbrs.end(), check) != nbrs.end();
+    };
+    std::size_t nrOdd = 0U;
+    for (std::size_t i = 0; i < nrFlip; i++) {
+        for (const auto check : pcm.getNbrs(flips[i])) { // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            bool counted = false;
+            bool odd     = true;
+            for (std::size_t j = 0; j < nrFlip && !counted; j++) {
+                if (j != i && isAdjacent(flips[j], check)) { // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                    counted = j < i;
+                    odd     = !odd;
+                }
+            }
+            if (counted || !odd) {
+                continue;
+            }
+            if (!syndrome.get(check - nrBits)) {
+                return false;
+            }
+            nrOdd++;
+        }
+    }
+    if (nrOdd != weight) {
+        return false;
+    }
+    correction.assign(flips, flips + nrFlip); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return true;
+}
+
+std::uint64_t SyndromeLookupTable::fingerprint(const ParityCheckMatrix& pcm) {
+    auto h = mixIndex(mixIndex(HASH_SEED, pcm.nrBits()), pcm.nrChecks());
+    for (const auto o : pcm.checkNbrOffsets) {
+        h = mixIndex(h, o);
+    }
+    for (const auto b : pcm.checkNbrs) {
+        h = mixIndex(h, b);
+    }
+    return h;
+}
+
+void SyndromeLookupTable::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw QeccException("Cannot open lookup table file for writing");
+    }
+    out.write(MAGIC.data(), MAGIC.size());
+    for (const auto value : {FORMAT_VERSION, static_cast<std::uint64_t>(nrBits), static_cast<std::uint64_t>(nrChecks), pcmFingerprint,
+                             static_cast<std::uint64_t>(requestedWeight), static_cast<std::uint64_t>(requestedBytes), static_cast<std::uint64_t>(maxWeight),
+                             static_cast<std::uint64_t>(maxSyndromeWeight), static_cast<std::uint64_t>(nrEntries)}) {
+        writeValue(out, value);
+    }
+    writeArray(out, keys);
+    writeArray(out, entries);
+    writeArray(out, corrections);
+    if (!out) {
+        throw QeccException("Cannot write lookup table file");
+    }
+}
+
+SyndromeLookupTable SyndromeLookupTable::load(const std::string& path, const ParityCheckMatrix& pcm) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw QeccException("Cannot open lookup table file");
+    }
+    std::array<char, MAGIC.size()> magic{};
+    in.read(magic.data(), magic.size());
+    if (!in || magic != MAGIC || readValue<std::uint64_t>(in) != FORMAT_VERSION) {
+        throw QeccException("Cannot read lookup table, unknown file format");
+    }
+    SyndromeLookupTable res;
+    res.nrBits            = readValue<std::uint64_t>(in);
+    res.nrChecks          = readValue<std::uint64_t>(in);
+    res.pcmFingerprint    = readValue<std::uint64_t>(in);
+    res.requestedWeight   = readValue<std::uint64_t>(in);
+    res.requestedBytes    = readValue<std::uint64_t>(in);
+    res.maxWeight         = readValue<std::uint64_t>(in);
+    res.maxSyndromeWeight = readValue<std::uint64_t>(in);
+    res.nrEntries         = readValue<std::uint64_t>(in);
+    if (!in || !res.matches(pcm)) {
+        throw QeccException("Cannot read lookup table, it was built for another check matrix");
+    }
+    const auto fileSize = static_cast<std::uint64_t>(std::filesystem::file_size(path));
+    res.keys            = readArray<std::uint64_t>(in, fileSize);
+    res.entries         = readArray<std::uint32_t>(in, fileSize);
+    res.corrections     = readArray<std::uint32_t>(in, fileSize);
+    bool valid = (res.keys.size() & (res.keys.size() - 1)) == 0U && res.entries.size() == res.keys.size();
+    for (std::size_t slot = 0; valid && slot < res.keys.size(); slot++) {
+        if (res.keys[slot] == 0U) {
+            continue;
+        }
+        const auto offset = static_cast<std::size_t>(res.entries[slot]);
+        valid             = offset < res.corrections.size() && res.corrections[offset] >= 1U && res.corrections[offset] <= res.maxWeight &&
+                offset + res.corrections[offset] < res.corrections.size();
+        for (std::size_t i = 1; valid && i <= res.corrections[offset]; i++) {
+            valid = res.corrections[offset + i] < res.nrBits;
+        }
+    }
+    if (!in || !valid) {
+        throw QeccException("Cannot read lookup table, file is corrupt");
+    }
+    return res;
+}
+
+SyndromeLookupTable SyndromeLookupTable::loadOrBuild(const std::string& path, const ParityCheckMatrix& pcm, const LookupTableConfig& config) {
+    if (std::filesystem::exists(path)) {
+        try {
+            auto cached = load(path, pcm);
+            if (cached.requestedWeight == config.maxWeight && cached.requestedBytes == config.maxBytes) {
+                return cached;
+            }
+        } catch (const QeccException&) {
+            // stale or corrupt cache, rebuilt below
+        }
+    }
+    SyndromeLookupTable res(pcm, config);
+    res.save(path);
+    return res;
+}
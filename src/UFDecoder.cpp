@@ -16,82 +16,102 @@
  * @param syndrome
  */
 void UFDecoder::decode(const gf2Vec& syndrome) {
-    if (syndrome.size() > this->getCode()->gethZ()->pcm->size()) {
+    if (!this->getCode()->gethZ()->pcm) {
+        throw QeccException("UFDecoder needs a dense parity-check matrix, use UFHeuristic on decoding graphs");
+    }
+    if (syndrome.size() > this->getCode()->gethZ()->nrChecks()) {
         std::vector<bool> xSyndr;
         std::vector<bool> zSyndr;
         auto              mid = syndrome.begin() + (static_cast<std::int64_t>(syndrome.size()) / 2U);
         std::move(syndrome.begin(), mid, std::back_inserter(xSyndr));
         std::move(mid, syndrome.end(), std::back_inserter(zSyndr));
-        doDecode(xSyndr, this->getCode()->gethZ());
+        doDecode(Gf2Vector(xSyndr), this->getCode()->gethZ());
         auto xres = this->result;
         this->reset();
-        doDecode(zSyndr, this->getCode()->gethX());
+        doDecode(Gf2Vector(zSyndr), this->getCode()->gethX());
         this->result.decodingTime += xres.decodingTime;
+        this->result.decodingNanos += xres.decodingNanos;
+        this->result.phaseNanos += xres.phaseNanos;
         std::move(xres.estimBoolVector.begin(), xres.estimBoolVector.end(), std::back_inserter(this->result.estimBoolVector));
         std::move(xres.estimNodeIdxVector.begin(), xres.estimNodeIdxVector.end(), std::back_inserter(this->result.estimNodeIdxVector));
     } else {
-        this->doDecode(syndrome, getCode()->gethZ()); // X errs per default if single sided
+        this->doDecode(Gf2Vector(syndrome), getCode()->gethZ()); // X errs per default if single sided
     }
 }
 
-void UFDecoder::doDecode(const std::vector<bool>& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm) {
-    const auto                                   decodingTimeBegin = std::chrono::high_resolution_clock::now();
-    std::unordered_set<std::size_t>              components; // used to store vertex indices in E set
-    std::vector<std::unordered_set<std::size_t>> invalidComponents;
-    std::unordered_set<std::size_t>              syndr; // vertex indices of syndrome nodes
-    for (std::size_t i = 0; i < syndrome.size(); i++) {
-        if (syndrome.at(i)) {
-            syndr.insert(getCode()->getN() + i);
-        }
-    }
+void UFDecoder::doDecode(const Gf2Vector& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm) {
+    const auto                                   decodingTimeBegin = std::chrono::steady_clock::now();
+    PhaseTimings                                 phases;
+    PhaseStopwatch                               stopwatch(phases);
+    std::vector<std::size_t> res;
+    const bool               tabulated = syndrome.any() && lookupCorrection(syndrome, pcm, res);
+    stopwatch.lap(DecodingPhase::Lookup);
+    if (!tabulated) {
+        std::vector<std::unordered_set<std::size_t>> invalidComponents;
+        // workspaces are reused between runs, clearing them only costs the number of vertices touched before
+        const auto nrNodes = pcm->nrBits() + pcm->nrChecks();
+        components.resize(nrNodes); // used to store vertex indices in E set
+        syndr.resize(nrNodes);      // vertex indices of syndrome nodes
+        syndrome.forEachSetBit([&](const std::size_t i) { syndr.insert(getCode()->getN() + i); });
 
-    if (!syndr.empty()) {
-        // Set set of nodes equal to syndrome E = syndrome
-        for (auto s : syndr) {
-            components.insert(s);
-        }
+        if (!syndr.empty()) {
+            // Set set of nodes equal to syndrome E = syndrome
+            for (auto s : syndr) {
+                components.insert(s);
+            }
+            stopwatch.lap(DecodingPhase::Setup);
 
-        while (containsInvalidComponents(components, syndr, invalidComponents, pcm) &&
-               components.size() < (pcm->pcm->size() + pcm->pcm->front().size())) {
-            if (this->growth == GrowthVariant::AllComponents) {
-                // // grow all components (including valid ones) by 1
-                standardGrowth(components);
-            } else if (this->growth == GrowthVariant::InvalidComponents) {
-                // not implemented yet
-            } else if (this->growth == GrowthVariant::SingleSmallest) {
-                // grow only by neighbours of single smallest cluster
-                singleClusterSmallestFirstGrowth(components);
-            } else if (this->growth == GrowthVariant::SingleRandom) {
-                // grow only by neighbours of single random cluster
-                singleClusterRandomFirstGrowth(components);
-            } else if (this->growth == GrowthVariant::SingleQubitRandom) {
-                // grow only by neighbours of single qubit
-                singleQubitRandomFirstGrowth(components);
-            } else {
-                throw std::invalid_argument("Unsupported growth variant");
+            while (true) {
+                // connected components are recomputed from scratch, so there is no separate fusion or boundary update,
+                // the validity check includes the Gaussian elimination of every component
+                const bool invalid = containsInvalidComponents(components, syndr, invalidComponents, pcm);
+                stopwatch.lap(DecodingPhase::ValidityCheck);
+                if (!invalid || components.size() >= (pcm->nrChecks() + pcm->nrBits())) {
+                    break;
+                }
+                if (this->growth == GrowthVariant::AllComponents) {
+                    // // grow all components (including valid ones) by 1
+                    standardGrowth(components);
+                } else if (this->growth == GrowthVariant::InvalidComponents) {
+                    // not implemented yet
+                } else if (this->growth == GrowthVariant::SingleSmallest) {
+                    // grow only by neighbours of single smallest cluster
+                    singleClusterSmallestFirstGrowth(components);
+                } else if (this->growth == GrowthVariant::SingleRandom) {
+                    // grow only by neighbours of single random cluster
+                    singleClusterRandomFirstGrowth(components);
+                } else if (this->growth == GrowthVariant::SingleQubitRandom) {
+                    // grow only by neighbours of single qubit
+                    singleQubitRandomFirstGrowth(components);
+                } else {
+                    throw std::invalid_argument("Unsupported growth variant");
+                }
+                stopwatch.lap(DecodingPhase::Growth);
             }
         }
-    }
 
-    std::vector<std::set<std::size_t>> estims;
-    auto                               ccomps = getConnectedComps(components);
-    for (const auto& comp : ccomps) {
-        auto compEstimate = getEstimateForComponent(comp, syndr, pcm);
-        estims.emplace_back(compEstimate.begin(), compEstimate.end());
-    }
-    std::set<std::size_t> tmp;
-    for (auto& estim : estims) {
-        tmp.insert(estim.begin(), estim.end());
+        std::vector<std::set<std::size_t>> estims;
+        auto                               ccomps = getConnectedComps(components);
+        for (const auto& comp : ccomps) {
+            auto compEstimate = getEstimateForComponent(comp, syndr, pcm);
+            estims.emplace_back(compEstimate.begin(), compEstimate.end());
+        }
+        std::set<std::size_t> tmp;
+        for (auto& estim : estims) {
+            tmp.insert(estim.begin(), estim.end());
+        }
+        res.assign(tmp.begin(), tmp.end());
+        stopwatch.lap(DecodingPhase::Solve);
     }
-    std::vector<std::size_t> res(tmp.begin(), tmp.end());
 
-    const auto decodingTimeEnd = std::chrono::high_resolution_clock::now();
-    result.decodingTime        = static_cast<std::size_t>(std::chrono::duration_cast<std::chrono::milliseconds>(decodingTimeEnd - decodingTimeBegin).count());
-    result.estimBoolVector     = std::vector<bool>(getCode()->getN());
+    result.estimBoolVector = std::vector<bool>(getCode()->getN());
     for (auto re : res) {
         result.estimBoolVector.at(re) = true;
     }
     result.estimNodeIdxVector = std::move(res);
+    stopwatch.lap(DecodingPhase::Output);
+    result.phaseNanos = phases;
+    result.setDecodingTime(std::chrono::steady_clock::now() - decodingTimeBegin);
 }
 
 /**
@@ -100,7 +120,7 @@ void UFDecoder::doDecode(const std::vector<bool>& syndrome, const std::unique_pt
  * @param syndrome
  * @return
  */
-bool UFDecoder::containsInvalidComponents(const std::unordered_set<std::size_t>& nodeSet, const std::unordered_set<std::size_t>& syndrome,
+bool UFDecoder::containsInvalidComponents(const StampedSet& nodeSet, const StampedSet& syndrome,
                                           std::vector<std::unordered_set<std::size_t>>& invalidComps,
                                           const std::unique_ptr<ParityCheckMatrix>&     pcm) const {
     auto ccomps = getConnectedComps(nodeSet);
@@ -121,7 +141,7 @@ bool UFDecoder::containsInvalidComponents(const std::unordered_set<std::size_t>&
  * @return
  */
 bool UFDecoder::isValidComponent(const std::unordered_set<std::size_t>&    nodeSet,
-                                 const std::unordered_set<std::size_t>&    syndrome,
+                                 const StampedSet&                         syndrome,
                                  const std::unique_ptr<ParityCheckMatrix>& pcm) const {
     return !getEstimateForComponent(nodeSet, syndrome, pcm).empty();
 }
@@ -153,7 +173,7 @@ std::vector<std::size_t> UFDecoder::computeInteriorBitNodes(const std::unordered
  * @return
  */
 std::unordered_set<std::size_t> UFDecoder::getEstimateForComponent(const std::unordered_set<std::size_t>&    nodeSet,
-                                                                   const std::unordered_set<std::size_t>&    syndrome,
+                                                                   const StampedSet&                         syndrome,
                                                                    const std::unique_ptr<ParityCheckMatrix>& pcm) const {
     std::unordered_set<std::size_t> res{};
 
@@ -161,42 +181,30 @@ std::unordered_set<std::size_t> UFDecoder::getEstimateForComponent(const std::un
     if (intNodes.empty()) {
         return std::unordered_set<std::size_t>{};
     }
-    gf2Mat            redHz;
-    gf2Vec            redSyndr(0);
-    std::vector<bool> used(pcm->pcm->size());
-
+    // collect the checks of the component and the checks adjacent to its bit nodes
+    usedChecks.resize(pcm->nrBits() + pcm->nrChecks());
+    const auto addCheck = [&](const std::size_t checkIdx) { usedChecks.insert(checkIdx); };
     for (const auto it : nodeSet) {
         if (it >= getCode()->getN()) { // is a check node
-            if (!used.at(it - getCode()->getN())) {
-                redHz.emplace_back(pcm->pcm->at(it - getCode()->getN()));
-                used.at(it - getCode()->getN()) = true;
-                if (syndrome.find(it - getCode()->getN()) != syndrome.end()) {
-                    redSyndr.emplace_back(1); // If the check node is in the syndrome we need to satisfy check=1
-                } else {
-                    redSyndr.emplace_back(0);
-                }
-            }
+            addCheck(it);
         } else { // is a bit node
-            const auto nbrs = this->getCode()->gethZ()->getNbrs(it);
-            for (auto n : nbrs) { // add neighbouring checks (these are maybe not in the interior but to stay consistent with the syndrome we need to include these in the check)
-                if (!used.at(n - getCode()->getN())) {
-                    redHz.emplace_back(pcm->pcm->at(n - getCode()->getN()));
-                    if (syndrome.find(n) != syndrome.end()) {
-                        redSyndr.emplace_back(1);
-                    } else {
-                        redSyndr.emplace_back(0);
-                    }
-                    used.at(n - getCode()->getN()) = true;
-                }
+            // add neighbouring checks (these are maybe not in the interior but to stay consistent with the syndrome we need to include these in the check)
+            for (const auto n : this->getCode()->gethZ()->getNbrs(it)) {
+                addCheck(n);
             }
         }
     }
-    auto estim = Utils::solveSystem(redHz, redSyndr); // solves the system redHz*x=redSyndr by x to see if a solution can be found
-    for (std::size_t i = 0; i < estim.size(); i++) {
-        if (estim.at(i)) {
-            res.insert(i);
+    const auto& redChecks = usedChecks;
+    Gf2Matrix   redHz(redChecks.size(), pcm->pcm->cols());
+    Gf2Vector   redSyndr(redChecks.size());
+    for (std::size_t i = 0; i < redChecks.size(); i++) {
+        redHz.copyRowFrom(i, *pcm->pcm, redChecks[i] - getCode()->getN());
+        if (syndrome.contains(redChecks[i])) {
+            redSyndr.set(i); // If the check node is in the syndrome we need to satisfy check=1
         }
     }
+    const auto estim = Utils::solveSystem(redHz, redSyndr); // solves the system redHz*x=redSyndr by x to see if a solution can be found
+    estim.forEachSetBit([&res](const std::size_t i) { res.insert(i); });
     return res;
 }
 
@@ -204,10 +212,11 @@ std::unordered_set<std::size_t> UFDecoder::getEstimateForComponent(const std::un
  * Grows the node set by the neighbours of ALL clusters
  * @param comps
  */
-void UFDecoder::standardGrowth(std::unordered_set<std::size_t>& comps) {
-    for (auto currCompIt = comps.begin(); currCompIt != comps.end(); currCompIt++) {
-        const auto nbrs = getCode()->gethZ()->getNbrs(*currCompIt);
-        for (auto n : nbrs) {
+void UFDecoder::standardGrowth(StampedSet& comps) {
+    // nodes added in this step are appended and not grown again
+    const auto nrComps = comps.size();
+    for (std::size_t i = 0; i < nrComps; i++) {
+        for (const auto n : getCode()->gethZ()->getNbrs(comps[i])) {
             comps.insert(n);
         }
     }
@@ -216,7 +225,7 @@ void UFDecoder::standardGrowth(std::unordered_set<std::size_t>& comps) {
  * Grows the node set by the neighbours of the single smallest cluster
  * @param nodeSet
  */
-void UFDecoder::singleClusterSmallestFirstGrowth(std::unordered_set<std::size_t>& nodeSet) {
+void UFDecoder::singleClusterSmallestFirstGrowth(StampedSet& nodeSet) {
     auto                            ccomps = getConnectedComps(nodeSet);
     std::unordered_set<std::size_t> smallestComponent;
     std::size_t                     smallestSize = SIZE_MAX;
@@ -228,8 +237,9 @@ void UFDecoder::singleClusterSmallestFirstGrowth(std::unordered_set<std::size_t>
     }
 
     for (auto node : smallestComponent) {
-        const auto& nbrs = getCode()->gethZ()->getNbrs(node);
-        nodeSet.insert(nbrs.begin(), nbrs.end());
+        for (const auto n : getCode()->gethZ()->getNbrs(node)) {
+            nodeSet.insert(n);
+        }
     }
 }
 
@@ -237,7 +247,7 @@ void UFDecoder::singleClusterSmallestFirstGrowth(std::unordered_set<std::size_t>
  * Grows the node set by the neighbours of a single random cluster
  * @param nodeSet
  */
-void UFDecoder::singleClusterRandomFirstGrowth(std::unordered_set<std::size_t>& nodeSet) {
+void UFDecoder::singleClusterRandomFirstGrowth(StampedSet& nodeSet) {
     auto                            ccomps = getConnectedComps(nodeSet);
     std::unordered_set<std::size_t> chosenComponent;
     std::random_device              rd;
@@ -249,8 +259,9 @@ void UFDecoder::singleClusterRandomFirstGrowth(std::unordered_set<std::size_t>&
     chosenComponent = *it;
 
     for (auto node : chosenComponent) {
-        const auto& nbrs = getCode()->gethZ()->getNbrs(node);
-        nodeSet.insert(nbrs.begin(), nbrs.end());
+        for (const auto n : getCode()->gethZ()->getNbrs(node)) {
+            nodeSet.insert(n);
+        }
     }
 }
 
@@ -266,45 +277,46 @@ void UFDecoder::reset() {
  * Grows the node set by the neighbours of a single random qubit
  * @param comps
  */
-void UFDecoder::singleQubitRandomFirstGrowth(std::unordered_set<std::size_t>& comps) {
+void UFDecoder::singleQubitRandomFirstGrowth(StampedSet& comps) {
     auto                            ccomps = getConnectedComps(comps);
     std::unordered_set<std::size_t> chosenComponent;
     std::random_device              rd;
     std::mt19937                    gen(rd());
-    std::uniform_int_distribution   d(static_cast<std::size_t>(0U), ccomps.size());
+    std::uniform_int_distribution   d(static_cast<std::size_t>(0U), ccomps.size() - 1);
     const std::size_t               chosenIdx = d(gen);
     auto                            it        = ccomps.begin();
     std::advance(it, chosenIdx);
     chosenComponent = *it;
 
-    const auto& nbrs = getCode()->gethZ()->getNbrs(*chosenComponent.begin());
-    comps.insert(nbrs.begin(), nbrs.end());
+    for (const auto n : getCode()->gethZ()->getNbrs(*chosenComponent.begin())) {
+        comps.insert(n);
+    }
 }
 /**
  * Given a set of nodes (the set of all nodes considered by the algorithm in the Tanner graph), compute the connected components in the Tanner graph
  * @param nodes
  * @return
  */
-std::vector<std::unordered_set<std::size_t>> UFDecoder::getConnectedComps(const std::unordered_set<std::size_t>& nodes) const {
-    std::unordered_set<std::size_t>              visited;
+std::vector<std::unordered_set<std::size_t>> UFDecoder::getConnectedComps(const StampedSet& nodes) const {
     std::vector<std::unordered_set<std::size_t>> res;
+    visited.resize(getCode()->gethZ()->nrBits() + getCode()->gethZ()->nrChecks());
 
     for (auto c : nodes) {
-        if (visited.find(c) == visited.end()) {
+        if (!visited.contains(c)) {
             visited.insert(c);
             std::unordered_set<std::size_t> ccomp;
 
-            std::queue<std::size_t> stack;
-            stack.push(c);
-            while (!stack.empty()) { // use DFS-like algorithm to compute connected component containing node 'c'
-                auto curr = stack.back();
-                stack.pop();
+            std::queue<std::size_t> queue;
+            queue.push(c);
+            while (!queue.empty()) { // BFS computing the connected component containing node 'c'
+                auto curr = queue.front();
+                queue.pop();
                 if (ccomp.find(curr) == ccomp.end()) {
                     ccomp.insert(curr);
                     auto nbrs = getCode()->gethZ()->getNbrs(curr);
                     for (auto n : nbrs) {
-                        if (ccomp.find(n) == ccomp.end() && nodes.find(n) != nodes.end()) {
-                            stack.push(n);
+                        if (ccomp.find(n) == ccomp.end() && nodes.contains(n)) {
+                            queue.push(n);
                             visited.insert(n);
                         }
                     }
@@ -5,10 +5,13 @@
 #include "UFHeuristic.hpp"
 
 #include "Decoder.hpp"
-#include "TreeNode.hpp"
+#include "Utils.hpp"
 
+#include <algorithm>
 #include <chrono>
-#include <queue>
+#include <cmath>
+#include <iterator>
+#include <limits>
 #include <random>
 /**
  * returns list of tree node (in UF data structure) representations for syndrome
@@ -16,18 +19,9 @@
  * @param syndrome
  * @return
  */
-std::unordered_set<std::size_t> UFHeuristic::computeInitTreeComponents(const gf2Vec& syndrome) {
+std::unordered_set<std::size_t> UFHeuristic::computeInitTreeComponents(const Gf2Vector& syndrome) {
     std::unordered_set<std::size_t> res{};
-    for (std::size_t i = 0; i < syndrome.size(); i++) {
-        if (syndrome.at(i)) {
-            const auto idx       = i + getCode()->getN();
-            auto       syndrNode = std::make_unique<TreeNode>(idx);
-            syndrNode->isCheck   = true;
-            syndrNode->checkVertices.emplace_back(syndrNode->vertexIdx);
-            nodeMap.try_emplace(syndrNode->vertexIdx, std::move(syndrNode));
-            res.insert(idx);
-        }
-    }
+    syndrome.forEachSetBit([&](const std::size_t i) { res.insert(i + getCode()->getN()); });
     return res;
 }
 
@@ -36,183 +30,172 @@ std::unordered_set<std::size_t> UFHeuristic::computeInitTreeComponents(const gf2
  * @param syndrome
  */
 void UFHeuristic::decode(const gf2Vec& syndrome) {
-    if (syndrome.size() > this->getCode()->gethZ()->pcm->size()) {
+    if (syndrome.size() > this->getCode()->gethZ()->nrChecks()) {
         std::vector<bool> xSyndr;
         std::vector<bool> zSyndr;
         auto              mid = syndrome.begin() + (static_cast<std::int64_t>(std::size(syndrome)) / 2U);
         std::move(syndrome.begin(), mid, std::back_inserter(xSyndr));
         std::move(mid, syndrome.end(), std::back_inserter(zSyndr));
-        doDecoding(xSyndr, this->getCode()->gethZ());
+        doDecoding(Gf2Vector(xSyndr), this->getCode()->gethZ());
         auto xres = this->result;
         this->reset();
-        doDecoding(zSyndr, this->getCode()->gethZ());
+        doDecoding(Gf2Vector(zSyndr), this->getCode()->gethZ());
         this->result.decodingTime += xres.decodingTime;
+        this->result.decodingNanos += xres.decodingNanos;
+        this->result.phaseNanos += xres.phaseNanos;
+        this->result.matchesSyndrome = this->result.matchesSyndrome && xres.matchesSyndrome;
         std::move(xres.estimBoolVector.begin(), xres.estimBoolVector.end(), std::back_inserter(this->result.estimBoolVector));
         std::move(xres.estimNodeIdxVector.begin(), xres.estimNodeIdxVector.end(), std::back_inserter(this->result.estimNodeIdxVector));
     } else {
-        this->doDecoding(syndrome, getCode()->gethZ()); // X errs per default if single sided
+        this->doDecoding(Gf2Vector(syndrome), getCode()->gethZ()); // X errs per default if single sided
     }
 }
 /**
  * Main part of the heuristic. Uses Union-Find datastructure for efficient cluster growth and validtiy check
  * @param syndrome
  */
-void UFHeuristic::doDecoding(const gf2Vec& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm) {
-    auto                     decodingTimeBegin = std::chrono::high_resolution_clock::now();
+void UFHeuristic::doDecoding(const Gf2Vector& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm) {
+    const auto               decodingTimeBegin = std::chrono::steady_clock::now();
+    PhaseTimings             phases;
+    PhaseStopwatch           stopwatch(phases);
     std::vector<std::size_t> res;
-    if (!syndrome.empty() && !std::all_of(syndrome.begin(), syndrome.end(), [](bool val) { return !val; })) {
+    const bool               tabulated = syndrome.any() && lookupCorrection(syndrome, pcm, res);
+    bool                     matched   = true;
+    stopwatch.lap(DecodingPhase::Lookup);
+    if (syndrome.any() && !tabulated) {
+        const auto nrNodes = pcm->nrBits() + pcm->nrChecks();
+        arena.reset(nrNodes);
+        peelChecks.resize(nrNodes);
+        clusterBits.resize(nrNodes);
+        grownBits.resize(nrNodes);
+        candidateBits.resize(nrNodes);
+        if (peelParentBit.size() < nrNodes) {
+            peelParentBit.resize(nrNodes);
+            peelParentCheck.resize(nrNodes);
+            peelParity.resize(nrNodes);
+            reducedColumn.resize(nrNodes);
+            growthProgress.resize(nrNodes);
+            growthRate.resize(nrNodes);
+        }
+        if (growth == GrowthVariant::Weighted && !qubitWeights.empty() && qubitWeights.size() != pcm->nrBits()) {
+            throw QeccException("Number of qubit weights does not match the code");
+        }
         auto                            syndrComponents   = computeInitTreeComponents(syndrome);
         auto                            invalidComponents = syndrComponents;
         std::unordered_set<std::size_t> erasure;
-        while (!invalidComponents.empty() && invalidComponents.size() < (this->getCode()->gethZ()->pcm->size() + getCode()->gethZ()->pcm->front().size())) {
+        for (const auto c : syndrComponents) {
+            arena.flipParity(c);
+        }
+        stopwatch.lap(DecodingPhase::Setup);
+        while (!invalidComponents.empty() && invalidComponents.size() < arena.size()) {
             // Step 1 growth
-            std::vector<std::pair<std::size_t, std::size_t>> fusionEdges;
-            std::unordered_map<std::size_t, bool>            presentMap; // for step 4
+            fusionEdgeBuffer.clear();
 
             if (this->growth == GrowthVariant::AllComponents) {
                 // to grow all components (including valid ones)
                 for (auto e : erasure) {
                     invalidComponents.insert(e);
                 }
-                standardGrowth(fusionEdges, presentMap, invalidComponents, pcm);
+                standardGrowth(fusionEdgeBuffer, invalidComponents, pcm);
             } else if (this->growth == GrowthVariant::InvalidComponents) {
-                standardGrowth(fusionEdges, presentMap, invalidComponents, pcm);
+                standardGrowth(fusionEdgeBuffer, invalidComponents, pcm);
             } else if (this->growth == GrowthVariant::SingleSmallest) {
-                singleClusterSmallestFirstGrowth(fusionEdges, presentMap, invalidComponents, pcm);
+                singleClusterSmallestFirstGrowth(fusionEdgeBuffer, invalidComponents, pcm);
             } else if (this->growth == GrowthVariant::SingleRandom) {
-                singleClusterRandomFirstGrowth(fusionEdges, presentMap, invalidComponents, pcm);
+                singleClusterRandomFirstGrowth(fusionEdgeBuffer, invalidComponents, pcm);
+            } else if (this->growth == GrowthVariant::Weighted) {
+                weightedGrowth(fusionEdgeBuffer, invalidComponents, pcm);
             } else {
                 throw std::invalid_argument("Unsupported growth variant");
             }
-            // Fuse clusters that grew together
-            auto eIt = fusionEdges.begin();
-            while (eIt != fusionEdges.end()) {
-                auto* n1    = getNodeFromIdx(eIt->first);
-                auto* n2    = getNodeFromIdx(eIt->second);
-                auto* root1 = TreeNode::Find(n1);
-                auto* root2 = TreeNode::Find(n2);
-                // compares vertexIdx only
-                if (root1->vertexIdx == root2->vertexIdx) {
-                    eIt = fusionEdges.erase(eIt); // passes eIt to erase
-                } else {
-                    auto s1 = root1->clusterSize; // sizes before union needed
-                    auto s2 = root2->clusterSize;
-                    TreeNode::Union(root1, root2);
-
-                    if (s1 <= s2) { // Step 3 fusion of boundary lists
-                        for (const auto& boundaryVertex : root1->boundaryVertices) {
-                            root2->boundaryVertices.insert(boundaryVertex);
-                        }
-                        root1->boundaryVertices.clear();
-                    } else {
-                        for (const auto& boundaryVertex : root2->boundaryVertices) {
-                            root1->boundaryVertices.insert(boundaryVertex);
-                        }
-                        root2->boundaryVertices.clear();
+            stopwatch.lap(DecodingPhase::Growth);
+            if (fusionEdgeBuffer.empty()) {
+                break; // the clusters cannot grow any further
+            }
+            // Step 2 and 3: fuse clusters that grew together, boundary lists are spliced by the arena
+            for (const auto& [v1, v2] : fusionEdgeBuffer) {
+                arena.unite(arena.find(v1), arena.find(v2));
+            }
+            if (this->growth == GrowthVariant::Weighted) {
+                // weighted growth adds bits together with all their checks, a bit with an odd number of checks changes the parity
+                for (const auto& [v1, v2] : fusionEdgeBuffer) {
+                    if (v1 < pcm->nrBits() && pcm->getNbrs(v1).size() % 2U == 1U) {
+                        arena.setOpen(arena.find(v1));
                     }
-                    ++eIt;
                 }
             }
             // Replace nodes in list by their roots avoiding duplicates
-            std::vector<std::size_t> toAdd;
-            auto                     idxIt = invalidComponents.begin();
-            while (idxIt != invalidComponents.end()) {
-                auto*       elem = getNodeFromIdx(*idxIt);
-                const auto& root = TreeNode::Find(elem);
-                if (elem->vertexIdx != root->vertexIdx && presentMap.find(root->vertexIdx) != presentMap.end()) {
-                    // root already in component list, no replacement necessary
-                    idxIt = invalidComponents.erase(idxIt);
-                } else {
-                    // root of component not yet in list, replace node by its root in components
-                    idxIt = invalidComponents.erase(idxIt);
-                    toAdd.emplace_back(root->vertexIdx);
-                }
-            }
-            for (auto c : toAdd) {
-                invalidComponents.insert(c);
+            std::unordered_set<std::size_t> roots;
+            for (const auto c : invalidComponents) {
+                roots.insert(arena.find(c));
             }
+            invalidComponents = std::move(roots);
+            stopwatch.lap(DecodingPhase::Fusion);
 
             // Update Boundary Lists: remove vertices that are not in boundary anymore
             for (const auto& compId : invalidComponents) {
-                const auto& compNode = getNodeFromIdx(compId);
-                auto        iter     = compNode->boundaryVertices.begin();
-                while (iter != compNode->boundaryVertices.end()) {
-                    const auto& nbrs     = pcm->getNbrs(*iter);
-                    auto*       currNode = getNodeFromIdx(*iter);
-                    const auto& currRoot = TreeNode::Find(currNode);
-                    for (const auto& nbr : nbrs) {
-                        auto* node = getNodeFromIdx(nbr);
-                        if (auto* const nbrRoot = TreeNode::Find(node); currRoot->vertexIdx != nbrRoot->vertexIdx) {
-                            // if we find one neighbour that is not in the same component the currNode is in the boundary
-                            iter++;
-                            break;
-                        }
-                        if (nbr == nbrs.back()) {
-                            // if we have checked all neighbours and found none in another component remove from boundary list
-                            // toRemoveList.emplace_back(*iter);
-                            iter = compNode->boundaryVertices.erase(iter);
-                            break;
-                        }
-                    }
-                }
+                // a vertex stays in the boundary if one of its neighbours is in another component
+                arena.filterBoundary(compId, [&](const std::size_t v) {
+                    const auto& nbrs = pcm->getNbrs(v);
+                    return std::any_of(nbrs.begin(), nbrs.end(), [&](const std::size_t nbr) { return arena.find(nbr) != compId; });
+                });
             }
+            stopwatch.lap(DecodingPhase::BoundaryUpdate);
             extractValidComponents(invalidComponents, erasure, pcm);
+            stopwatch.lap(DecodingPhase::ValidityCheck);
         }
-        res = erasureDecoder(erasure, syndrComponents, pcm);
+        // clusters that stopped growing while invalid are decoded with their boundary bits, what they leave unexplained is
+        // solved by the fallback of the erasure decoder
+        erasure.insert(invalidComponents.begin(), invalidComponents.end());
+        matched = erasureDecoder(erasure, syndrComponents, pcm, res);
+        stopwatch.lap(DecodingPhase::Solve);
     }
-    auto decodingTimeEnd   = std::chrono::high_resolution_clock::now();
     result                 = DecodingResult();
-    result.decodingTime    = static_cast<std::size_t>(std::chrono::duration_cast<std::chrono::milliseconds>(decodingTimeEnd - decodingTimeBegin).count());
+    result.matchesSyndrome = matched;
     result.estimBoolVector = gf2Vec(getCode()->getN());
     for (const auto& re : res) {
         result.estimBoolVector.at(re) = true;
         result.estimNodeIdxVector.emplace_back(re);
     }
+    stopwatch.lap(DecodingPhase::Output);
+    result.phaseNanos = phases;
+    result.setDecodingTime(std::chrono::steady_clock::now() - decodingTimeBegin);
+}
+
+/**
+ * Adds an edge from each boundary vertex of the cluster to each of its neighbours
+ */
+void UFHeuristic::growCluster(std::vector<std::pair<std::size_t, std::size_t>>& fusionEdges, const std::size_t root, const std::unique_ptr<ParityCheckMatrix>& pcm) const {
+    arena.forEachBoundaryVertex(root, [&](const std::size_t bndryNode) {
+        for (const auto nbr : pcm->getNbrs(bndryNode)) {
+            fusionEdges.emplace_back(bndryNode, nbr);
+        }
+    });
 }
 
 void UFHeuristic::standardGrowth(std::vector<std::pair<std::size_t, std::size_t>>& fusionEdges,
-                                 std::unordered_map<std::size_t, bool>&            presentMap,
                                  const std::unordered_set<std::size_t>&            components,
                                  const std::unique_ptr<ParityCheckMatrix>&         pcm) {
     for (const auto& compId : components) {
-        const auto& compNode = getNodeFromIdx(compId);
-        presentMap.try_emplace(compNode->vertexIdx, true);
-        const auto& bndryNodes = compNode->boundaryVertices;
-
-        for (const auto& bndryNode : bndryNodes) {
-            const auto& nbrs = pcm->getNbrs(bndryNode);
-            for (const auto& nbr : nbrs) {
-                fusionEdges.emplace_back(bndryNode, nbr);
-            }
-        }
+        growCluster(fusionEdges, compId, pcm);
     }
 }
 
 void UFHeuristic::singleClusterSmallestFirstGrowth(std::vector<std::pair<std::size_t, std::size_t>>& fusionEdges,
-                                                   std::unordered_map<std::size_t, bool>& presentMap, const std::unordered_set<std::size_t>& components, const std::unique_ptr<ParityCheckMatrix>& pcm) {
+                                                   const std::unordered_set<std::size_t>&            components,
+                                                   const std::unique_ptr<ParityCheckMatrix>&         pcm) {
     std::size_t smallestComponent = *components.begin();
     std::size_t smallestSize      = SIZE_MAX;
     for (const auto& cId : components) {
-        const auto& comp = getNodeFromIdx(cId);
-        if (comp->clusterSize < smallestSize) {
-            smallestComponent = comp->vertexIdx;
-            smallestSize      = comp->clusterSize;
-        }
-    }
-    const auto& smallestC = getNodeFromIdx(smallestComponent);
-    presentMap.try_emplace(smallestC->vertexIdx, true);
-    const auto& bndryNodes = smallestC->boundaryVertices;
-
-    for (const auto& bndryNode : bndryNodes) {
-        const auto& nbrs = pcm->getNbrs(bndryNode);
-        for (const auto& nbr : nbrs) {
-            fusionEdges.emplace_back(bndryNode, nbr);
+        if (arena.getClusterSize(cId) < smallestSize) {
+            smallestComponent = cId;
+            smallestSize      = arena.getClusterSize(cId);
         }
     }
+    growCluster(fusionEdges, smallestComponent, pcm);
 }
 
 void UFHeuristic::singleClusterRandomFirstGrowth(std::vector<std::pair<std::size_t, std::size_t>>& fusionEdges,
-                                                 std::unordered_map<std::size_t, bool>&            presentMap,
                                                  const std::unordered_set<std::size_t>&            components,
                                                  const std::unique_ptr<ParityCheckMatrix>&         pcm) {
     std::random_device rd;
@@ -224,93 +207,304 @@ void UFHeuristic::singleClusterRandomFirstGrowth(std::vector<std::pair<std::size
     const std::size_t             chosenIdx = d(gen);
     auto                          it        = components.begin();
     std::advance(it, chosenIdx);
-    auto        chosenComponent = *it;
-    const auto& chosenNode      = getNodeFromIdx(chosenComponent);
+    growCluster(fusionEdges, *it, pcm);
+}
 
-    presentMap.try_emplace(chosenNode->vertexIdx, true);
-    const auto& bndryNodes = chosenNode->boundaryVertices;
+/**
+ * Grows the boundary checks of the components towards their bits by the smallest amount that completes a bit, like Dijkstra's
+ * algorithm on all clusters at once. Growth of several checks towards the same bit adds up, so clusters meet halfway.
+ * Completed bits join the clusters of all their checks, boundary bits reach their checks at no cost
+ */
+void UFHeuristic::weightedGrowth(std::vector<std::pair<std::size_t, std::size_t>>& fusionEdges,
+                                 const std::unordered_set<std::size_t>&            components,
+                                 const std::unique_ptr<ParityCheckMatrix>&         pcm) {
+    const auto n = getCode()->getN();
+    candidateBits.clear();
+    for (const auto& compId : components) {
+        arena.forEachBoundaryVertex(compId, [&](const std::size_t v) {
+            if (v < n) {
+                for (const auto nbr : pcm->getNbrs(v)) {
+                    fusionEdges.emplace_back(v, nbr);
+                }
+                return;
+            }
+            for (const auto bit : pcm->getNbrs(v)) {
+                if (arena.find(bit) == compId) {
+                    continue;
+                }
+                if (grownBits.insert(bit)) {
+                    growthProgress[bit] = 0U;
+                }
+                if (candidateBits.insert(bit)) {
+                    growthRate[bit] = 0U;
+                }
+                growthRate[bit]++;
+            }
+        });
+    }
+    if (candidateBits.empty()) {
+        return;
+    }
+    auto step = std::numeric_limits<std::uint32_t>::max();
+    for (const auto bit : candidateBits) {
+        const auto remaining = weightOf(bit) - growthProgress[bit];
+        step                 = std::min(step, (remaining + growthRate[bit] - 1U) / growthRate[bit]);
+    }
+    for (const auto bit : candidateBits) {
+        growthProgress[bit] = std::min(weightOf(bit), growthProgress[bit] + step * growthRate[bit]);
+        if (growthProgress[bit] == weightOf(bit)) {
+            for (const auto check : pcm->getNbrs(bit)) {
+                fusionEdges.emplace_back(bit, check);
+            }
+        }
+    }
+}
 
-    for (const auto& bndryNode : bndryNodes) {
-        const auto& nbrs = pcm->getNbrs(bndryNode);
-        for (const auto& nbr : nbrs) {
-            fusionEdges.emplace_back(bndryNode, nbr);
+std::uint32_t UFHeuristic::weightOf(const std::size_t bit) const {
+    return qubitWeights.empty() ? 1U : qubitWeights[bit];
+}
+
+void UFHeuristic::setErrorProbabilities(const std::vector<double>& probabilities) {
+    std::vector<std::uint32_t> weights(probabilities.size());
+    for (std::size_t i = 0; i < probabilities.size(); i++) {
+        const auto p = probabilities[i];
+        if (!(p > 0.0 && p < 1.0)) {
+            throw QeccException("Error probabilities must be in (0, 1)");
         }
+        weights[i] = static_cast<std::uint32_t>(std::max(1.0, std::round(std::log((1.0 - p) / p) * WEIGHT_SCALE)));
     }
+    qubitWeights = std::move(weights);
 }
 
 /**
- * Computes interior of erasure with BFS algorithm then iterates over interior and removes neighbours of check vertices iteratively
+ * Decodes each final cluster by peeling, clusters that cannot be peeled are solved by Gaussian elimination
  * @param erasure
  * @param syndrome
- * @return
+ * @param estimate flipped bits
+ * @return false if no estimate with the given syndrome exists
  */
-std::vector<std::size_t> UFHeuristic::erasureDecoder(std::unordered_set<std::size_t>& erasure, std::unordered_set<std::size_t>& syndr, const std::unique_ptr<ParityCheckMatrix>& pcm) {
-    std::unordered_set<std::size_t>       syndrome(syndr.begin(), syndr.end());
-    std::vector<std::vector<std::size_t>> erasureSet{};
-    // compute interior of grown erasure components, that is nodes all of whose neighbours are also in the component
-    for (const auto& currCompRootId : erasure) {
-        std::vector<std::size_t> compErasure;
-        const auto&              currCompRoot = getNodeFromIdx(currCompRootId);
-        std::queue<std::size_t>  queue;
-
-        // start traversal at component root
-        queue.push(currCompRoot->vertexIdx);
+bool UFHeuristic::erasureDecoder(std::unordered_set<std::size_t>& erasure, std::unordered_set<std::size_t>& syndr, const std::unique_ptr<ParityCheckMatrix>& pcm,
+                                 std::vector<std::size_t>& estimate) {
+    // valid components may have been merged in later growth steps, visit each final cluster once
+    std::unordered_set<std::size_t> erasureRoots;
+    for (const auto& e : erasure) {
+        erasureRoots.insert(arena.find(e));
+    }
+    std::vector<std::size_t> unsolvedRoots;
+    for (const auto& currCompRootId : erasureRoots) {
+        // validity of a cluster does not guarantee that its interior explains the syndrome, then also use its boundary bits
+        if (!peelCluster(currCompRootId, syndr, pcm, estimate) && !solveCluster(currCompRootId, syndr, pcm, false, estimate) &&
+            !solveCluster(currCompRootId, syndr, pcm, true, estimate)) {
+            unsolvedRoots.emplace_back(currCompRootId);
+        }
+    }
+    // solutions of clusters sharing checks through their boundary bits can also leave part of the syndrome unexplained
+    return solveResidual(unsolvedRoots, syndr, pcm, estimate);
+}
 
-        while (!queue.empty()) {
-            const auto& currV = getNodeFromIdx(queue.front());
-            queue.pop();
-            if ((!currV->marked && (currCompRoot->boundaryVertices.find(currV->vertexIdx)) == currCompRoot->boundaryVertices.end()) || currV->isCheck) { // we need check nodes also if they are not in the "interior" or if there is only a restricted interior
-                // add to interior by adding it to the list and marking it
-                currV->marked = true;
-                compErasure.emplace_back(currV->vertexIdx);
+/**
+ * Solves the part of the syndrome left unexplained by the estimate, first on the bits of the unsolved clusters and the bits next
+ * to the unexplained checks, then on all bits. Bits flipped by both the estimate and the solution cancel
+ * @return false if the syndrome has no solution at all, in which case the estimate is left unchanged
+ */
+bool UFHeuristic::solveResidual(const std::vector<std::size_t>& unsolvedRoots, const std::unordered_set<std::size_t>& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm,
+                                std::vector<std::size_t>& estimate) {
+    const auto                      n        = getCode()->getN();
+    std::unordered_set<std::size_t> residual = syndrome;
+    for (const auto bit : estimate) {
+        for (const auto check : pcm->getNbrs(bit)) {
+            if (residual.erase(check) == 0U) {
+                residual.insert(check);
             }
-
-            for (const auto& node : currV->children) {
-                if ((!node->marked && (currCompRoot->boundaryVertices.find(node->vertexIdx)) == currCompRoot->boundaryVertices.end()) || node->isCheck) { // we need check nodes also if they are not in the "interior" or if there is only a restricted interior
-                    // add to interior by adding it to the list and marking it
-                    node->marked = true;
-                    compErasure.emplace_back(node->vertexIdx);
-                }
-                queue.push(node->vertexIdx); // step into depth
+        }
+    }
+    if (residual.empty()) {
+        return true;
+    }
+    clusterBits.clear();
+    peelChecks.clear();
+    const auto addBit = [&](const std::size_t bit) {
+        if (clusterBits.insert(bit)) {
+            for (const auto check : pcm->getNbrs(bit)) {
+                peelChecks.insert(check);
             }
         }
-        erasureSet.emplace_back(compErasure);
+    };
+    for (const auto root : unsolvedRoots) {
+        arena.forEachMember(root, [&](const std::size_t v) {
+            if (v < n) {
+                addBit(v);
+            } else {
+                peelChecks.insert(v);
+            }
+        });
+    }
+    for (const auto check : residual) {
+        peelChecks.insert(check);
+        for (const auto bit : pcm->getNbrs(check)) {
+            addBit(bit);
+        }
+    }
+    std::vector<std::size_t> fix;
+    if (!solveReduced(residual, pcm, fix)) {
+        clusterBits.clear();
+        peelChecks.clear();
+        for (std::size_t bit = 0; bit < n; bit++) {
+            addBit(bit);
+        }
+        for (const auto check : residual) {
+            peelChecks.insert(check);
+        }
+        if (!solveReduced(residual, pcm, fix)) {
+            return false;
+        }
+    }
+    std::sort(estimate.begin(), estimate.end());
+    std::sort(fix.begin(), fix.end());
+    std::vector<std::size_t> merged;
+    std::set_symmetric_difference(estimate.begin(), estimate.end(), fix.begin(), fix.end(), std::back_inserter(merged));
+    estimate = std::move(merged);
+    return true;
+}
+
+/**
+ * Bits in the interior of the cluster, that is all of whose neighbours are in the cluster, form the erasure
+ */
+bool UFHeuristic::isErased(const std::size_t v, const std::size_t root) {
+    return v < getCode()->getN() && !arena.isBoundary(v) && arena.find(v) == root;
+}
+
+/**
+ * Peeling decoder of Delfosse and Zemor: erased bits of degree two are edges between their checks and bits of degree one
+ * edges to the open boundary. A spanning forest of these edges is built by breadth first search, then leaves are removed
+ * in reverse order, flipping the edge to the parent whenever the leaf check is unsatisfied. Erased bits outside the forest
+ * are not flipped. Runs in time linear in the size of the cluster
+ * @return false if the cluster contains bits of higher degree or a tree without boundary has odd syndrome,
+ * in which case the estimate is left unchanged
+ */
+bool UFHeuristic::peelCluster(const std::size_t root, const std::unordered_set<std::size_t>& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm, std::vector<std::size_t>& estimate) {
+    constexpr auto NIL      = UnionFindArena::NIL;
+    const auto     n        = getCode()->getN();
+    bool           peelable = true;
+    arena.forEachMember(root, [&](const std::size_t v) {
+        if (peelable && isErased(v, root) && pcm->getNbrs(v).size() > 2U) {
+            peelable = false; // hyperedge
+        }
+    });
+    if (!peelable) {
+        return false;
     }
 
-    std::vector<std::size_t> resList;
-    // go through nodes in erasure
-    // if current node v is a bit node in Int, remove adjacent check nodes c_i and B(c_i,1)
-    for (auto& component : erasureSet) {
-        auto compNodeIt = component.begin();
-        while (compNodeIt != component.end() && !syndrome.empty()) {
-            const auto& currN = getNodeFromIdx(*compNodeIt++);
-            if (!currN->isCheck && !currN->deleted) {
-                resList.emplace_back(currN->vertexIdx); // add bit node to estimate
-                // if we add a bit node we have to delete adjacent check nodes and their neighbours
-                for (const auto& adjCheck : pcm->getNbrs(currN->vertexIdx)) {
-                    const auto& adjCheckNode = getNodeFromIdx(adjCheck);
-                    if (adjCheckNode->marked && !adjCheckNode->deleted) {
-                        const auto& nNbrs = pcm->getNbrs(adjCheck);
-                        auto        nnbr  = nNbrs.begin();
-                        // remove bit nodes adjacent to neighbour check
-                        while (nnbr != nNbrs.end()) {
-                            const auto& nnbrNode = getNodeFromIdx(*nnbr++);
-                            if (!nnbrNode->deleted && nnbrNode->marked) { // also removes currN
-                                nnbrNode->deleted = true;
-                            }
-                        }
-                        // remove check from syndrome and component
-                        syndrome.erase(adjCheckNode->vertexIdx);
-                        adjCheckNode->deleted = true;
+    peelChecks.clear();
+    const auto visit = [&](const std::size_t check, const std::size_t viaBit, const std::size_t fromCheck) {
+        peelChecks.insert(check);
+        peelParentBit[check]   = static_cast<std::uint32_t>(viaBit);
+        peelParentCheck[check] = static_cast<std::uint32_t>(fromCheck);
+        peelParity[check]      = syndrome.count(check) != 0U ? 1U : 0U;
+    };
+    // the queue of the search is the insertion order of the visited checks
+    std::size_t head    = 0U;
+    const auto  explore = [&]() {
+        for (; head < peelChecks.size(); head++) {
+            const auto check = peelChecks[head];
+            for (const auto bit : pcm->getNbrs(check)) {
+                if (!isErased(bit, root)) {
+                    continue;
+                }
+                for (const auto other : pcm->getNbrs(bit)) {
+                    if (!peelChecks.contains(other)) {
+                        visit(other, bit, check);
                     }
                 }
-                // finally, remove node bitnode
-                currN->deleted = true;
             }
         }
+    };
+    // trees touching the open boundary are rooted there, so that the boundary absorbs their parity
+    arena.forEachMember(root, [&](const std::size_t v) {
+        if (isErased(v, root) && pcm->getNbrs(v).size() == 1U && !peelChecks.contains(pcm->getNbrs(v).front())) {
+            visit(pcm->getNbrs(v).front(), v, NIL);
+            explore();
+        }
+    });
+    arena.forEachMember(root, [&](const std::size_t v) {
+        if (v >= n && !peelChecks.contains(v)) {
+            visit(v, NIL, NIL);
+            explore();
+        }
+    });
+
+    const auto nrEstimated = estimate.size();
+    for (auto i = peelChecks.size(); i-- > 0U;) {
+        const auto check = peelChecks[i];
+        if (peelParity[check] == 0U) {
+            continue;
+        }
+        if (peelParentBit[check] == NIL) { // root of a tree with odd syndrome
+            estimate.resize(nrEstimated);
+            return false;
+        }
+        estimate.emplace_back(peelParentBit[check]);
+        if (peelParentCheck[check] != NIL) {
+            peelParity[peelParentCheck[check]] ^= 1U;
+        }
     }
+    return true;
+}
+
+/**
+ * Solves the syndrome of the cluster restricted to its bits by Gaussian elimination
+ * @param withBoundary if true all bits of the cluster are used, otherwise only the erased ones
+ * @return false if the system has no solution, in which case the estimate is left unchanged
+ */
+bool UFHeuristic::solveCluster(const std::size_t root, const std::unordered_set<std::size_t>& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm,
+                               const bool withBoundary, std::vector<std::size_t>& estimate) {
+    const auto n = getCode()->getN();
+    // rows are the checks of the cluster and the checks adjacent to the chosen bits, which must stay satisfied
+    clusterBits.clear();
+    peelChecks.clear();
+    arena.forEachMember(root, [&](const std::size_t v) {
+        if (v >= n) {
+            peelChecks.insert(v);
+        } else if (withBoundary || isErased(v, root)) {
+            clusterBits.insert(v);
+            for (const auto check : pcm->getNbrs(v)) {
+                peelChecks.insert(check);
+            }
+        }
+    });
+    return solveReduced(syndrome, pcm, estimate);
+}
 
-    return resList;
+/**
+ * Solves the syndrome on the checks of peelChecks with the bits of clusterBits by Gaussian elimination, the checks have to
+ * include all neighbours of the bits
+ * @return false if the system has no solution, in which case the estimate is left unchanged
+ */
+bool UFHeuristic::solveReduced(const std::unordered_set<std::size_t>& syndrome, const std::unique_ptr<ParityCheckMatrix>& pcm, std::vector<std::size_t>& estimate) {
+    if (clusterBits.empty()) {
+        return std::none_of(peelChecks.begin(), peelChecks.end(), [&](const std::size_t c) { return syndrome.count(c) != 0U; });
+    }
+    for (std::size_t j = 0; j < clusterBits.size(); j++) {
+        reducedColumn[clusterBits[j]] = static_cast<std::uint32_t>(j);
+    }
+    Gf2Matrix redHz(peelChecks.size(), clusterBits.size());
+    Gf2Vector redSyndr(peelChecks.size());
+    for (std::size_t i = 0; i < peelChecks.size(); i++) {
+        for (const auto bit : pcm->getNbrs(peelChecks[i])) {
+            if (clusterBits.contains(bit)) {
+                redHz.set(i, reducedColumn[bit]);
+            }
+        }
+        if (syndrome.count(peelChecks[i]) != 0U) {
+            redSyndr.set(i);
+        }
+    }
+    const auto estim = Utils::solveSystem(redHz, redSyndr);
+    if (estim.empty()) {
+        return false;
+    }
+    estim.forEachSetBit([&](const std::size_t j) { estimate.emplace_back(clusterBits[j]); });
+    return true;
 }
 
 /**
@@ -321,7 +515,10 @@ std::vector<std::size_t> UFHeuristic::erasureDecoder(std::unordered_set<std::siz
 void UFHeuristic::extractValidComponents(std::unordered_set<std::size_t>& invalidComponents, std::unordered_set<std::size_t>& validComponents, const std::unique_ptr<ParityCheckMatrix>& pcm) {
     auto it = invalidComponents.begin();
     while (it != invalidComponents.end()) {
-        if (isValidComponent(*it, pcm)) {
+        // weighted growth absorbs single bits, the neighbourhood criterion would accept clusters before they explain their syndrome.
+        // The parity kept by the arena is exact for bits with at most two checks, final clusters are solved by the erasure decoder
+        const bool valid = growth == GrowthVariant::Weighted ? arena.isNeutral(*it) : isValidComponent(*it, pcm);
+        if (valid) {
             validComponents.insert(*it);
             it = invalidComponents.erase(it);
         } else {
@@ -333,52 +530,21 @@ void UFHeuristic::extractValidComponents(std::unordered_set<std::size_t>& invali
 // for each check node verify that there is no neighbour that is in the boundary of the component
 // if there is no neighbour in the boundary for each check vertex the check is covered by a node in Int TODO prove this in paper
 bool UFHeuristic::isValidComponent(const std::size_t& compId, const std::unique_ptr<ParityCheckMatrix>& pcm) {
-    const auto& compNode = getNodeFromIdx(compId);
-    gf2Vec      valid(compNode->checkVertices.size());
-    std::size_t i = 0U;
-    for (const auto& checkVertex : compNode->checkVertices) {
-        const auto& nbrs = pcm->getNbrs(checkVertex);
-        for (const auto& nbr : nbrs) {
-            if (compNode->boundaryVertices.find(nbr) == compNode->boundaryVertices.end()) {
-                valid.at(i) = true;
-                break;
-            }
+    const auto n     = getCode()->getN();
+    bool       valid = true;
+    arena.forEachMember(compId, [&](const std::size_t checkVertex) {
+        if (!valid || checkVertex < n) {
+            return;
         }
-        i++;
-    }
-    return std::all_of(valid.begin(), valid.end(), [](bool v) { return v; });
-}
-
-// return raw ptr to leave ownership in list
-TreeNode* UFHeuristic::getNodeFromIdx(const std::size_t idx) {
-    if (auto nodeIt = nodeMap.find(idx); nodeIt != nodeMap.end()) {
-        return nodeIt->second.get();
-    }
-
-    auto treeNode = std::make_unique<TreeNode>(idx);
-    // determine if idx is a check
-    if (idx >= getCode()->getN()) {
-        treeNode->isCheck = true;
-        treeNode->checkVertices.emplace_back(treeNode->vertexIdx);
-    }
-    const auto ins = nodeMap.try_emplace(idx, std::move(treeNode));
-    return ins.first->second.get();
+        const auto& nbrs = pcm->getNbrs(checkVertex);
+        valid            = std::any_of(nbrs.begin(), nbrs.end(), [&](const std::size_t nbr) {
+            return !arena.isBoundary(nbr) || arena.find(nbr) != compId;
+        });
+    });
+    return valid;
 }
 
 void UFHeuristic::reset() {
-    for (auto& n : nodeMap) {
-        for (auto& c : n.second->children) {
-            c = nullptr;
-        }
-        n.second->children.clear();
-        n.second->parent = nullptr;
-        n.second.reset();
-    }
-    nodeMap.clear();
     this->result = {};
     this->growth = GrowthVariant::AllComponents;
-    this->getCode()->gethZ()->nbrCache.clear();
-    if (this->getCode()->gethZ()) {
-        this->getCode()->gethZ()->nbrCache.clear();
-    }
 }
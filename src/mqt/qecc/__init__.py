@@ -10,15 +10,28 @@ from ._version import version as __version__
 from .pyqecc import (
     Code,
     Decoder,
+    DecoderComparison,
+    DecoderConfig,
     DecodingResult,
     DecodingResultStatus,
     DecodingRunInformation,
     GrowthVariant,
+    LatencyHistogram,
+    LookupTableConfig,
+    ResultsFormat,
+    SlidingWindowDecoder,
+    StoppingCriteria,
+    SyndromeLookupTable,
     UFDecoder,
     UFHeuristic,
+    WeightStrata,
+    WeightStratum,
+    WerEstimate,
     apply_ecc,
     sample_iid_pauli_err,
+    sample_sparse_iid_pauli_err,
 )
+from .results import ShotResults, load_results
 
 __all__ = [
     "__version__",
@@ -31,5 +44,19 @@ __all__ = [
     "DecodingResultStatus",
     "DecodingRunInformation",
     "sample_iid_pauli_err",
+    "sample_sparse_iid_pauli_err",
     "apply_ecc",
+    "LatencyHistogram",
+    "ResultsFormat",
+    "ShotResults",
+    "load_results",
+    "StoppingCriteria",
+    "WerEstimate",
+    "WeightStratum",
+    "WeightStrata",
+    "DecoderConfig",
+    "DecoderComparison",
+    "SlidingWindowDecoder",
+    "LookupTableConfig",
+    "SyndromeLookupTable",
 ]
@@ -28,11 +28,30 @@ class Code:
     k: int
     n: int
 
+class LookupTableConfig:
+    max_weight: int
+    max_bytes: int
+    nr_threads: int
+    def __init__(self) -> None: ...
+
+class SyndromeLookupTable:
+    def __init__(self, code: Code, config: LookupTableConfig = ...) -> None: ...
+    @staticmethod
+    def load_or_build(path: str, code: Code, config: LookupTableConfig = ...) -> SyndromeLookupTable: ...
+    def save(self, path: str) -> None: ...
+    @property
+    def size(self) -> int: ...
+    @property
+    def max_weight(self) -> int: ...
+    @property
+    def memory_bytes(self) -> int: ...
+
 class Decoder:
     def __init__(self) -> None: ...
     def decode(self, arg0: list[bool]) -> None: ...
     def set_code(self, arg0: Code) -> None: ...
     def set_growth(self, arg0: GrowthVariant) -> None: ...
+    def set_lookup_table(self, table: SyndromeLookupTable | None) -> None: ...
 
     growth: GrowthVariant
     result: DecodingResult
@@ -60,13 +79,51 @@ class DecoderType:
     @property
     def value(self) -> int: ...
 
+class LatencyHistogram:
+    def __init__(self) -> None: ...
+    def record(self, nanos: int) -> None: ...
+    def merge(self, other: LatencyHistogram) -> None: ...
+    @property
+    def count(self) -> int: ...
+    @property
+    def min(self) -> int: ...
+    @property
+    def max(self) -> int: ...
+    @property
+    def mean(self) -> float: ...
+    def value_at_percentile(self, percentile: float) -> int: ...
+    def buckets(self) -> list[tuple[int, int, int]]: ...
+    def json(self) -> dict[str, Any]: ...
+
+class ResultsFormat:
+    __members__: ClassVar[dict[ResultsFormat, int]] = ...  # read-only
+    NDJSON: ClassVar[ResultsFormat] = ...
+    COLUMNAR: ClassVar[ResultsFormat] = ...
+
+    def __init__(self, value: int) -> None: ...
+    def __eq__(self, other: object) -> bool: ...
+    def __getstate__(self) -> int: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: object) -> bool: ...
+    def __setstate__(self, state: int) -> None: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
+
 class DecodingResult:
     def __init__(self) -> None: ...
     def json(self) -> dict[str, Any]: ...
 
     decoding_time: int
+    decoding_nanos: int
     estim_vec_idxs: list[int]
     estimate: list[bool]
+    matches_syndrome: bool
+    @property
+    def phase_nanos(self) -> dict[str, int]: ...
 
 class DecodingResultStatus:
     __members__: ClassVar[dict[DecodingResultStatus, int]] = ...  # read-only
@@ -125,19 +182,154 @@ class DecodingRunInformation:
 class DecodingSimulator:
     def __init__(self) -> None: ...
     def simulate_avg_runtime(
-        self, arg0: str, arg1: float, arg2: int, arg3: str, arg4: int, arg5: DecoderType
-    ) -> None: ...
+        self,
+        raw_data_output_filepath: str,
+        decoding_info_outfile_path: str,
+        physical_err_rate: float,
+        nr_runs: int,
+        codes_path: str,
+        nr_samples: int,
+        decoder_type: DecoderType,
+        nr_threads: int = ...,
+        seed: int | None = ...,
+        nr_warmup_shots: int = ...,
+    ) -> dict[str, LatencyHistogram]: ...
     def simulate_wer(
         self,
-        arg0: str,
-        arg1: float,
-        arg2: float,
-        arg3: int,
-        arg4: Code,
-        arg5: float,
-        arg6: DecoderType,
+        raw_data_output_filepath: str,
+        stats_output_filepath: str,
+        min_physical_err_rate: float,
+        max_physical_err_rate: float,
+        nr_runs_per_rate: int,
+        code: Code,
+        per_step_size: float,
+        decoder_type: DecoderType,
+        nr_threads: int = ...,
+        seed: int | None = ...,
+        stats_format: ResultsFormat = ...,
     ) -> None: ...
 
+    def simulate_wer_adaptive(
+        self,
+        raw_data_output_filepath: str,
+        min_physical_err_rate: float,
+        max_physical_err_rate: float,
+        per_step_size: float,
+        code: Code,
+        decoder_type: DecoderType,
+        criteria: StoppingCriteria,
+        nr_threads: int = ...,
+        seed: int | None = ...,
+    ) -> list[WerEstimate]: ...
+    def simulate_wer_coupled(
+        self,
+        raw_data_output_filepath: str,
+        min_physical_err_rate: float,
+        max_physical_err_rate: float,
+        per_step_size: float,
+        nr_runs_per_rate: int,
+        code: Code,
+        decoder_type: DecoderType,
+        nr_threads: int = ...,
+        seed: int | None = ...,
+    ) -> list[WerEstimate]: ...
+    def simulate_wer_phenomenological(
+        self,
+        raw_data_output_filepath: str,
+        min_physical_err_rate: float,
+        max_physical_err_rate: float,
+        per_step_size: float,
+        nr_runs_per_rate: int,
+        code: Code,
+        decoder_type: DecoderType,
+        rounds: int,
+        measurement_err_rate: float | None = ...,
+        nr_threads: int = ...,
+        seed: int | None = ...,
+    ) -> list[WerEstimate]: ...
+    def compare_decoders(
+        self,
+        raw_data_output_filepath: str,
+        physical_err_rate: float,
+        nr_shots: int,
+        code: Code,
+        configs: list[DecoderConfig],
+        nr_threads: int = ...,
+        seed: int | None = ...,
+    ) -> DecoderComparison: ...
+    def simulate_wer_stratified(
+        self,
+        raw_data_output_filepath: str,
+        physical_err_rates: list[float],
+        code: Code,
+        decoder_type: DecoderType,
+        max_weight: int,
+        shots_per_weight: int,
+        enumeration_limit: int = ...,
+        nr_threads: int = ...,
+        seed: int | None = ...,
+    ) -> WeightStrata: ...
+    @staticmethod
+    def wilson_interval(failures: int, shots: int, z: float = ...) -> tuple[float, float]: ...
+
+class StoppingCriteria:
+    target_failures: int
+    target_relative_width: float
+    max_shots: int
+    max_seconds: float
+    z: float
+    def __init__(self) -> None: ...
+
+class WerEstimate:
+    physical_err_rate: float
+    shots: int
+    failures: int
+    word_err_rate: float
+    lower: float
+    upper: float
+    seconds: float
+    def __init__(self) -> None: ...
+    def json(self) -> dict[str, Any]: ...
+
+class DecoderConfig:
+    decoder_type: DecoderType
+    growth: GrowthVariant
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, decoder_type: DecoderType, growth: GrowthVariant = ...) -> None: ...
+    def json(self) -> dict[str, Any]: ...
+
+class DecoderComparison:
+    physical_err_rate: float
+    shots: int
+    decoded: int
+    configs: list[DecoderConfig]
+    failures: list[int]
+    decoding_nanos: list[int]
+    only_failed: list[list[int]]
+    def __init__(self) -> None: ...
+    def disagreements(self, i: int, j: int) -> int: ...
+    def mean_latency_nanos(self, i: int) -> float: ...
+    def json(self) -> dict[str, Any]: ...
+
+class WeightStratum:
+    weight: int
+    shots: int
+    failures: int
+    exact: bool
+    def __init__(self) -> None: ...
+    def json(self) -> dict[str, Any]: ...
+
+class WeightStrata:
+    n: int
+    k: int
+    strata: list[WeightStratum]
+    def __init__(self) -> None: ...
+    def estimate(self, physical_err_rate: float, z: float = ...) -> WerEstimate: ...
+    def binomial_weight(self, weight: int, physical_err_rate: float) -> float: ...
+    def json(self) -> dict[str, Any]: ...
+
 class GrowthVariant:
     __members__: ClassVar[dict[GrowthVariant, int]] = ...  # read-only
     all_components: ClassVar[GrowthVariant] = ...
@@ -145,6 +337,7 @@ class GrowthVariant:
     single_smallest: ClassVar[GrowthVariant] = ...
     single_random: ClassVar[GrowthVariant] = ...
     single_qubit_random: ClassVar[GrowthVariant] = ...
+    weighted: ClassVar[GrowthVariant] = ...
 
     @overload
     def __init__(self, value: int) -> None: ...
@@ -176,10 +369,29 @@ class UFDecoder(Decoder):
     @result.setter
     def result(self, arg0: DecodingResult) -> None: ...
 
+class SlidingWindowDecoder:
+    def __init__(self, code: Code, window_rounds: int, commit_rounds: int) -> None: ...
+    def set_growth(self, arg0: GrowthVariant) -> None: ...
+    def set_error_rates(self, data_err_rate: float, measurement_err_rate: float) -> None: ...
+    def push_round(self, syndrome: list[bool]) -> int: ...
+    def finish(self, final_syndrome: list[bool]) -> int: ...
+    def reset(self) -> None: ...
+    @property
+    def correction(self) -> list[bool]: ...
+    @property
+    def committed_rounds(self) -> int: ...
+    @property
+    def buffered_rounds(self) -> int: ...
+    @property
+    def window_latencies(self) -> LatencyHistogram: ...
+
 class UFHeuristic(Decoder):
     def __init__(self) -> None: ...
     def decode(self, arg0: list[bool]) -> None: ...
     def reset(self) -> None: ...
+    def set_error_probabilities(self, probabilities: list[float]) -> None: ...
+    @property
+    def qubit_weights(self) -> list[int]: ...
     @property
     def growth(self) -> GrowthVariant: ...
     @growth.setter
@@ -191,3 +403,4 @@ class UFHeuristic(Decoder):
 
 def apply_ecc(circuit_name: object, ecc_name: str, ecc_frequency: int = 100) -> dict[str, str]: ...
 def sample_iid_pauli_err(arg0: int, arg1: float) -> list[bool]: ...
+def sample_sparse_iid_pauli_err(length: int, physical_err_rate: float, seed: int) -> list[int]: ...
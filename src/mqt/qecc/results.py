@@ -0,0 +1,95 @@
+"""Zero-copy reader for the binary columnar per-shot results written by the decoding simulator."""
+
+from __future__ import annotations
+
+import json
+from dataclasses import dataclass
+from pathlib import Path
+
+import numpy as np
+import numpy.typing as npt
+
+_FORMAT = "mqt-qecc-columnar"
+_VERSION = 1
+
+
+def _map_column(path: Path, dtype: npt.DTypeLike) -> npt.NDArray[np.generic]:
+    """Memory-map a little-endian column file, empty files cannot be mapped and yield an empty array."""
+    dt = np.dtype(dtype).newbyteorder("<")
+    if not path.exists() or path.stat().st_size < dt.itemsize:
+        return np.empty(0, dtype=dt)
+    count = path.stat().st_size // dt.itemsize
+    return np.memmap(path, dtype=dt, mode="r", shape=(count,))
+
+
+@dataclass(frozen=True)
+class ShotResults:
+    """Per-shot decoding results, each field is a read-only view of a column file.
+
+    The sparse syndrome and estimate of shot i are the index ranges [offsets[i], offsets[i+1]) of the respective index columns.
+    """
+
+    p: npt.NDArray[np.float64]
+    code: npt.NDArray[np.uint32]
+    status: npt.NDArray[np.uint8]  # 0 success, 1 failure
+    latency_ns: npt.NDArray[np.uint64]
+    syndrome_offsets: npt.NDArray[np.uint64]
+    syndrome_indices: npt.NDArray[np.uint32]
+    estimate_offsets: npt.NDArray[np.uint64]
+    estimate_indices: npt.NDArray[np.uint32]
+
+    def __len__(self) -> int:
+        """Return the number of shots."""
+        return len(self.p)
+
+    def failed(self) -> npt.NDArray[np.bool_]:
+        """Return a mask of the failed shots."""
+        return self.status != 0
+
+    def syndrome(self, i: int) -> npt.NDArray[np.uint32]:
+        """Return the indices of the violated checks of shot i."""
+        return self.syndrome_indices[int(self.syndrome_offsets[i]) : int(self.syndrome_offsets[i + 1])]
+
+    def estimate(self, i: int) -> npt.NDArray[np.uint32]:
+        """Return the indices of the qubits flipped by the decoder in shot i."""
+        return self.estimate_indices[int(self.estimate_offsets[i]) : int(self.estimate_offsets[i + 1])]
+
+
+def load_results(directory: str | Path) -> ShotResults:
+    """Map the columns of a results directory written with ResultsFormat.Columnar without copying or parsing.
+
+    If the writer did not finish (no meta.json), the shots that were completely written are returned.
+    """
+    path = Path(directory)
+    meta_path = path / "meta.json"
+    nr_records = None
+    if meta_path.exists():
+        meta = json.loads(meta_path.read_text())
+        if meta.get("format") != _FORMAT or meta.get("version") != _VERSION:
+            msg = f"Unsupported results format in {path}"
+            raise ValueError(msg)
+        nr_records = int(meta["records"])
+
+    p = _map_column(path / "p.f64", np.float64)
+    code = _map_column(path / "code.u32", np.uint32)
+    status = _map_column(path / "status.u8", np.uint8)
+    latency_ns = _map_column(path / "latency_ns.u64", np.uint64)
+    syndrome_offsets = _map_column(path / "syndrome_offsets.u64", np.uint64)
+    estimate_offsets = _map_column(path / "estimate_offsets.u64", np.uint64)
+    # columns are appended independently, only shots present in every column are complete
+    complete = min(len(p), len(code), len(status), len(latency_ns), len(syndrome_offsets) - 1, len(estimate_offsets) - 1)
+    n = max(complete, 0) if nr_records is None else min(nr_records, complete)
+    syndrome_offsets = syndrome_offsets[: n + 1]
+    estimate_offsets = estimate_offsets[: n + 1]
+    syndrome_indices = _map_column(path / "syndrome_indices.u32", np.uint32)
+    estimate_indices = _map_column(path / "estimate_indices.u32", np.uint32)
+    return ShotResults(
+        p=p[:n],
+        code=code[:n],
+        status=status[:n],
+        latency_ns=latency_ns[:n],
+        syndrome_offsets=syndrome_offsets,
+        syndrome_indices=syndrome_indices[: int(syndrome_offsets[-1]) if n > 0 else 0],
+        estimate_offsets=estimate_offsets,
+        estimate_indices=estimate_indices[: int(estimate_offsets[-1]) if n > 0 else 0],
+    )
@@ -7,6 +7,8 @@
 #include "DecodingRunInformation.hpp"
 #include "DecodingSimulator.hpp"
 #include "QuantumComputation.hpp"
+#include "SlidingWindowDecoder.hpp"
+#include "SyndromeLookupTable.hpp"
 #include "UFDecoder.hpp"
 #include "UFHeuristic.hpp"
 #include "ecc/Ecc.hpp"
@@ -32,6 +34,10 @@ std::vector<bool> sampleIidPauliErr(const std::size_t length, const double physi
     return Utils::sampleErrorIidPauliNoise(length, physicalErrRate);
 }
 
+std::vector<std::size_t> sampleSparseIidPauliErr(const std::size_t length, const double physicalErrRate, const std::uint64_t seed) {
+    return Utils::sampleSparseErrorIidPauliNoise(length, physicalErrRate, seed);
+}
+
 py::dict applyEcc(const py::object& circ, const std::string& eccName, const size_t eccFrequency) {
     auto qc = std::make_shared<qc::QuantumComputation>();
 
@@ -97,6 +103,8 @@ PYBIND11_MODULE(pyqecc, m) {
     // Additionally, the required parameters are described.
     m.doc() = "pybind11 for the MQT QECC quantum error-correcting codes tool";
     m.def("sample_iid_pauli_err", &sampleIidPauliErr, "Sample a iid pauli error represented as binary string");
+    m.def("sample_sparse_iid_pauli_err", &sampleSparseIidPauliErr, "Sample a iid pauli error represented as sorted list of flipped qubit indices, reproducible from the seed",
+          "length"_a, "physical_err_rate"_a, "seed"_a);
 
     py::class_<Code>(m, "Code", "CSS code object")
             .def(py::init<>(), "Constructs Code object without pcms set")
@@ -125,23 +133,48 @@ PYBIND11_MODULE(pyqecc, m) {
             .value("SINGLE_SMALLEST", GrowthVariant::SingleSmallest, "Grows only smallest component in each iteration")
             .value("SINGLE_RANDOM", GrowthVariant::SingleRandom, "Grows a single uniformly random component in each iteration")
             .value("SINGLE_QUBIT_RANDOM", GrowthVariant::SingleQubitRandom, "Grows component around a single qubit in each iteration")
+            .value("WEIGHTED", GrowthVariant::Weighted, "Grows invalid components towards qubits in order of their error probability (UFHeuristic only)")
             .export_values()
             .def(py::init([](const std::string& str) -> GrowthVariant { return growthVariantFromString(str); }));
 
     py::class_<DecodingResult>(m, "DecodingResult", "Holds information about a single decoding step")
             .def(py::init<>())
             .def_readwrite("decoding_time", &DecodingResult::decodingTime, "Time used for a single decoding step")
+            .def_readwrite("decoding_nanos", &DecodingResult::decodingNanos, "Time used for a single decoding step in ns")
+            .def_property_readonly(
+                    "phase_nanos", [](const DecodingResult& res) { return res.phaseNanos.to_json(); }, "Time spent in each decoding phase in ns, only recorded if built with MQT_QECC_PHASE_TIMING")
             .def_readwrite("estim_vec_idxs", &DecodingResult::estimNodeIdxVector, "Computed estimates given as indices (over qubits)")
             .def_readwrite("estimate", &DecodingResult::estimBoolVector, "Computed estimate as boolean vector")
+            .def_readwrite("matches_syndrome", &DecodingResult::matchesSyndrome, "False if the decoder found no estimate with the given syndrome")
             .def("json", &DecodingResult::to_json)
             .def("__repr__", &DecodingResult::toString);
 
+    py::class_<LookupTableConfig>(m, "LookupTableConfig", "Weight limit, memory budget and threads of a syndrome lookup table")
+            .def(py::init<>())
+            .def_readwrite("max_weight", &LookupTableConfig::maxWeight, "Largest weight of the tabulated errors")
+            .def_readwrite("max_bytes", &LookupTableConfig::maxBytes, "Memory budget, weights that do not fit are left to the decoder")
+            .def_readwrite("nr_threads", &LookupTableConfig::nrThreads, "Threads building the table, 0 for all hardware threads");
+
+    py::class_<SyndromeLookupTable, std::shared_ptr<SyndromeLookupTable>>(m, "SyndromeLookupTable", "Minimum-weight corrections of the syndromes of low-weight errors of hZ")
+            .def(py::init([](const Code& code, const LookupTableConfig& config) { return SyndromeLookupTable(*code.gethZ(), config); }),
+                 "code"_a, "config"_a = LookupTableConfig{})
+            .def_static(
+                    "load_or_build", [](const std::string& path, const Code& code, const LookupTableConfig& config) { return SyndromeLookupTable::loadOrBuild(path, *code.gethZ(), config); },
+                    "Reads the table from the cache file if it matches code and config, otherwise builds and writes it", "path"_a, "code"_a, "config"_a = LookupTableConfig{})
+            .def("save", &SyndromeLookupTable::save, "path"_a)
+            .def_property_readonly("size", &SyndromeLookupTable::size)
+            .def_property_readonly("max_weight", &SyndromeLookupTable::getMaxWeight)
+            .def_property_readonly("memory_bytes", &SyndromeLookupTable::memoryBytes);
+
     py::class_<Decoder>(m, "Decoder", "Decoder object")
             .def(py::init<>())
             .def_readwrite("result", &Decoder::result, "Decoding result object")
             .def_readwrite("growth", &Decoder::growth, "The growth variant currently set")
-            .def("set_code", &Decoder::setCode)
+            .def("set_code", py::overload_cast<const Code&>(&Decoder::setCode))
             .def("set_growth", &Decoder::setGrowth)
+            .def(
+                    "set_lookup_table", [](Decoder& self, const std::shared_ptr<SyndromeLookupTable>& table) { self.setLookupTable(table); },
+                    "Sets a table of low-weight syndromes looked up before clustering, None to disable", "table"_a)
             .def("decode", &Decoder::decode, "Decode a syndrome vector. After completion the result field is not null");
 
     py::class_<UFHeuristic, Decoder>(m, "UFHeuristic", "UFHeuristic object")
@@ -149,6 +182,8 @@ PYBIND11_MODULE(pyqecc, m) {
             .def_readwrite("result", &UFHeuristic::result)
             .def_readwrite("growth", &UFHeuristic::growth)
             .def("reset", &UFHeuristic::reset)
+            .def("set_error_probabilities", &UFHeuristic::setErrorProbabilities, "Sets per-qubit error probabilities for weighted growth", "probabilities"_a)
+            .def_property_readonly("qubit_weights", &UFHeuristic::getQubitWeights)
             .def("decode", &UFHeuristic::decode);
 
     py::class_<UFDecoder, Decoder>(m, "UFDecoder", "UFDecoder object")
@@ -157,6 +192,19 @@ PYBIND11_MODULE(pyqecc, m) {
             .def_readwrite("growth", &UFDecoder::growth)
             .def("decode", &UFDecoder::decode);
 
+    py::class_<SlidingWindowDecoder>(m, "SlidingWindowDecoder", "Streaming decoder of syndrome rounds with a sliding window, commits the oldest rounds of each window")
+            .def(py::init([](const Code& code, const std::size_t window, const std::size_t commit) { return SlidingWindowDecoder(std::make_shared<const Code>(code), window, commit); }),
+                 "code"_a, "window_rounds"_a, "commit_rounds"_a)
+            .def("set_growth", &SlidingWindowDecoder::setGrowth)
+            .def("set_error_rates", &SlidingWindowDecoder::setErrorRates, "Sets data and measurement error rates for weighted growth", "data_err_rate"_a, "measurement_err_rate"_a)
+            .def("push_round", &SlidingWindowDecoder::pushRound, "Adds the syndrome of the next round, returns the number of committed rounds", "syndrome"_a)
+            .def("finish", &SlidingWindowDecoder::finish, "Adds the perfect syndrome of the last round and commits all buffered rounds", "final_syndrome"_a)
+            .def("reset", &SlidingWindowDecoder::reset)
+            .def_property_readonly("correction", &SlidingWindowDecoder::getCorrection)
+            .def_property_readonly("committed_rounds", &SlidingWindowDecoder::getCommittedRounds)
+            .def_property_readonly("buffered_rounds", &SlidingWindowDecoder::getBufferedRounds)
+            .def_property_readonly("window_latencies", &SlidingWindowDecoder::getWindowLatencies);
+
     py::enum_<DecodingResultStatus>(m, "DecodingResultStatus")
             .value("ALL_COMPONENTS", DecodingResultStatus::SUCCESS)
             .value("INVALID_COMPONENTS", DecodingResultStatus::FAILURE)
@@ -176,10 +224,109 @@ PYBIND11_MODULE(pyqecc, m) {
             .def("json", &DecodingRunInformation::to_json)
             .def("__repr__", &DecodingRunInformation::toString);
 
+    py::class_<StoppingCriteria>(m, "StoppingCriteria", "Stopping rule of the adaptive WER simulation, targets set to 0 are disabled")
+            .def(py::init<>())
+            .def_readwrite("target_failures", &StoppingCriteria::targetFailures, "Number of logical failures after which to stop")
+            .def_readwrite("target_relative_width", &StoppingCriteria::targetRelativeWidth, "Width of the confidence interval relative to the estimate after which to stop")
+            .def_readwrite("max_shots", &StoppingCriteria::maxShots, "Maximum number of shots per physical error rate")
+            .def_readwrite("max_seconds", &StoppingCriteria::maxSeconds, "Maximum wall time per physical error rate")
+            .def_readwrite("z", &StoppingCriteria::z, "Standard normal quantile of the confidence interval");
+
+    py::class_<WerEstimate>(m, "WerEstimate", "Word error rate estimate with Wilson score interval")
+            .def(py::init<>())
+            .def_readwrite("physical_err_rate", &WerEstimate::physicalErrRate)
+            .def_readwrite("shots", &WerEstimate::shots, "Number of shots spent")
+            .def_readwrite("failures", &WerEstimate::failures, "Number of logical failures")
+            .def_readwrite("word_err_rate", &WerEstimate::wordErrRate)
+            .def_readwrite("lower", &WerEstimate::lower, "Lower bound of the confidence interval")
+            .def_readwrite("upper", &WerEstimate::upper, "Upper bound of the confidence interval")
+            .def_readwrite("seconds", &WerEstimate::seconds, "Wall time spent")
+            .def("json", &WerEstimate::to_json)
+            .def("__repr__", &WerEstimate::toString);
+
+    py::class_<WeightStratum>(m, "WeightStratum", "Decoding failures for errors of a fixed weight")
+            .def(py::init<>())
+            .def_readwrite("weight", &WeightStratum::weight)
+            .def_readwrite("shots", &WeightStratum::shots)
+            .def_readwrite("failures", &WeightStratum::failures)
+            .def_readwrite("exact", &WeightStratum::exact, "True if all errors of this weight were decoded")
+            .def("json", &WeightStratum::to_json);
+
+    py::class_<WeightStrata>(m, "WeightStrata", "Conditional failure rates per error weight")
+            .def(py::init<>())
+            .def_readwrite("n", &WeightStrata::n)
+            .def_readwrite("k", &WeightStrata::k)
+            .def_readwrite("strata", &WeightStrata::strata)
+            .def("estimate", &WeightStrata::estimate, "WER at the given physical error rate", "physical_err_rate"_a, "z"_a = 1.96)
+            .def("binomial_weight", &WeightStrata::binomialWeight, "weight"_a, "physical_err_rate"_a)
+            .def("json", &WeightStrata::to_json);
+
+    py::class_<DecoderConfig>(m, "DecoderConfig", "Decoder and growth variant compared on common shots")
+            .def(py::init<>())
+            .def(py::init([](DecoderType decoderType, GrowthVariant growth) { return DecoderConfig{decoderType, growth}; }), "decoder_type"_a, "growth"_a = GrowthVariant::AllComponents)
+            .def_readwrite("decoder_type", &DecoderConfig::decoderType)
+            .def_readwrite("growth", &DecoderConfig::growth)
+            .def("json", &DecoderConfig::to_json);
+
+    py::class_<DecoderComparison>(m, "DecoderComparison", "Paired statistics of decoder configurations on identical shots")
+            .def(py::init<>())
+            .def_readwrite("physical_err_rate", &DecoderComparison::physicalErrRate)
+            .def_readwrite("shots", &DecoderComparison::shots)
+            .def_readwrite("decoded", &DecoderComparison::decoded, "Number of shots with nontrivial syndrome")
+            .def_readwrite("configs", &DecoderComparison::configs)
+            .def_readwrite("failures", &DecoderComparison::failures, "Failures per configuration")
+            .def_readwrite("decoding_nanos", &DecoderComparison::decodingNanos, "Total decoding time per configuration")
+            .def_readwrite("only_failed", &DecoderComparison::onlyFailed, "only_failed[i][j] counts the shots on which i failed and j succeeded")
+            .def("disagreements", &DecoderComparison::disagreements, "i"_a, "j"_a)
+            .def("mean_latency_nanos", &DecoderComparison::meanLatencyNanos, "i"_a)
+            .def("json", &DecoderComparison::to_json)
+            .def("__repr__", &DecoderComparison::toString);
+
+    py::class_<LatencyHistogram>(m, "LatencyHistogram", "Log-bucketed, mergeable histogram of decoding latencies in ns")
+            .def(py::init<>())
+            .def("record", &LatencyHistogram::record, "nanos"_a)
+            .def(
+                    "merge", [](LatencyHistogram& self, const LatencyHistogram& other) { self += other; }, "Adds the counts of another histogram", "other"_a)
+            .def_property_readonly("count", &LatencyHistogram::count)
+            .def_property_readonly("min", &LatencyHistogram::min)
+            .def_property_readonly("max", &LatencyHistogram::max)
+            .def_property_readonly("mean", &LatencyHistogram::mean)
+            .def("value_at_percentile", &LatencyHistogram::valueAtPercentile, "percentile"_a)
+            .def("buckets", &LatencyHistogram::buckets, "Non-empty buckets as (lowest value, highest value, count)")
+            .def("json", &LatencyHistogram::to_json)
+            .def("__repr__", &LatencyHistogram::toString);
+
+    py::enum_<ResultsFormat>(m, "ResultsFormat")
+            .value("NDJSON", ResultsFormat::Ndjson, "Newline delimited json, one line per shot")
+            .value("COLUMNAR", ResultsFormat::Columnar, "Directory of binary column files, see mqt.qecc.load_results")
+            .export_values();
+
     py::class_<DecodingSimulator>(m, "DecodingSimulator")
             .def(py::init<>())
-            .def("simulate_wer", &DecodingSimulator::simulateWER)
-            .def("simulate_avg_runtime", &DecodingSimulator::simulateAverageRuntime);
+            .def("simulate_wer", &DecodingSimulator::simulateWER,
+                 "raw_data_output_filepath"_a, "stats_output_filepath"_a, "min_physical_err_rate"_a, "max_physical_err_rate"_a,
+                 "nr_runs_per_rate"_a, "code"_a, "per_step_size"_a, "decoder_type"_a, "nr_threads"_a = 1U, "seed"_a = py::none(),
+                 "stats_format"_a = ResultsFormat::Ndjson)
+            .def("simulate_avg_runtime", &DecodingSimulator::simulateAverageRuntime,
+                 "raw_data_output_filepath"_a, "decoding_info_outfile_path"_a, "physical_err_rate"_a, "nr_runs"_a,
+                 "codes_path"_a, "nr_samples"_a, "decoder_type"_a, "nr_threads"_a = 1U, "seed"_a = py::none(), "nr_warmup_shots"_a = 100U)
+            .def("simulate_wer_adaptive", &DecodingSimulator::simulateWERAdaptive,
+                 "raw_data_output_filepath"_a, "min_physical_err_rate"_a, "max_physical_err_rate"_a, "per_step_size"_a,
+                 "code"_a, "decoder_type"_a, "criteria"_a, "nr_threads"_a = 1U, "seed"_a = py::none())
+            .def("simulate_wer_coupled", &DecodingSimulator::simulateWERCoupled,
+                 "raw_data_output_filepath"_a, "min_physical_err_rate"_a, "max_physical_err_rate"_a, "per_step_size"_a,
+                 "nr_runs_per_rate"_a, "code"_a, "decoder_type"_a, "nr_threads"_a = 1U, "seed"_a = py::none())
+            .def("simulate_wer_phenomenological", &DecodingSimulator::simulateWERPhenomenological,
+                 "raw_data_output_filepath"_a, "min_physical_err_rate"_a, "max_physical_err_rate"_a, "per_step_size"_a,
+                 "nr_runs_per_rate"_a, "code"_a, "decoder_type"_a, "rounds"_a, "measurement_err_rate"_a = py::none(),
+                 "nr_threads"_a = 1U, "seed"_a = py::none())
+            .def("compare_decoders", &DecodingSimulator::compareDecoders,
+                 "raw_data_output_filepath"_a, "physical_err_rate"_a, "nr_shots"_a, "code"_a, "configs"_a,
+                 "nr_threads"_a = 1U, "seed"_a = py::none())
+            .def("simulate_wer_stratified", &DecodingSimulator::simulateWERStratified,
+                 "raw_data_output_filepath"_a, "physical_err_rates"_a, "code"_a, "decoder_type"_a, "max_weight"_a,
+                 "shots_per_weight"_a, "enumeration_limit"_a = 10000U, "nr_threads"_a = 1U, "seed"_a = py::none())
+            .def_static("wilson_interval", &DecodingSimulator::wilsonInterval, "failures"_a, "shots"_a, "z"_a = 1.96);
 
     py::enum_<DecoderType>(m, "DecoderType")
             .value("UF_HEURISTIC", DecoderType::UfHeuristic)
@@ -29,21 +29,21 @@ void runtime(const std::string& codename) {
     const std::size_t nrRuns    = 1000;
     const std::size_t nrSamples = 50;
     const double      per       = 0.01;
-    auto              code      = Code(inPath + codename);
-    const auto        coden     = code.getN();
+    const auto        code      = std::make_shared<const Code>(inPath + codename);
+    const auto        coden     = code->getN();
+    auto              decoder   = UFDecoder();
+    decoder.setCode(code);
 
     std::size_t samplesSum = 0;
 
     for (std::size_t i = 0; i < nrSamples; i++) {
         auto runsSum = 0U;
         for (std::size_t j = 0; j < nrRuns; j++) {
-            auto decoder = UFDecoder();
-            decoder.setCode(code);
             std::vector<bool> error;
             while (error.empty() || std::none_of(error.begin(), error.end(), [](bool c) { return c; })) {
                 error = Utils::sampleErrorIidPauliNoise(coden, per);
             }
-            auto syndrome = code.getXSyndrome(error);
+            auto syndrome = code->getXSyndrome(error);
             decoder.decode(syndrome);
             runsSum += decoder.result.decodingTime;
             decoder.reset();
@@ -52,7 +52,6 @@ void runtime(const std::string& codename) {
         samplesSum += runsSum;
     }
     std::cout << codename << ":" << samplesSum / nrSamples << std::endl;
-    flint_cleanup();
 }
 
 void decodingPerformance(const double per) {
@@ -62,22 +61,22 @@ void decodingPerformance(const double per) {
     const std::size_t                          nrRuns    = 1000;
     std::map<std::string, double, std::less<>> wordErrRatePerPhysicalErrRate;
 
-    auto       code = HGPcode(rootPath, rootPath2, codeK);
-    const auto n    = code.getN();
+    const auto code    = std::make_shared<const Code>(HGPcode(rootPath, rootPath2, codeK));
+    const auto n       = code->getN();
+    auto       decoder = std::make_unique<UFDecoder>();
+    decoder->setCode(code);
 
     std::size_t nrOfFailedRuns   = 0U;
     std::size_t nrSuccessfulRuns = 0U;
     std::size_t j                = 0;
     while (nrOfFailedRuns < 1 || j < nrRuns) {
-        auto decoder = std::make_unique<UFDecoder>();
-        decoder->setCode(code);
         auto error    = Utils::sampleErrorIidPauliNoise(n, per);
-        auto syndrome = code.getXSyndrome(error);
+        auto syndrome = code->getXSyndrome(error);
         decoder->decode(syndrome);
         auto const&       decodingResult = decoder->result;
         std::vector<bool> residualErr    = decodingResult.estimBoolVector;
         Utils::computeResidualErr(error, residualErr);
-        auto success = code.isXStabilizer(residualErr);
+        auto success = code->isXStabilizer(residualErr);
         if (!success) {
             nrOfFailedRuns++;
         } else {
@@ -91,7 +90,6 @@ void decodingPerformance(const double per) {
     const auto wordErrRate    = 1.0 - std::pow(1 - logicalErrRate, (1.0 / codeK)); // rate of codewords for decoder does not give correct answer (fails or introduces logical operator)
     std::cout << "per:wer = " << per << ":" << wordErrRate << std::endl;
     std::cout.flush();
-    flint_cleanup();
 }
 
 int main(int argc, char* argv[]) {         // NOLINT(clang-diagnostic-unused-parameter, bugprone-exception-escape,misc-unused-parameters)
@@ -0,0 +1,399 @@
+/**
+ * Google Benchmark suite of the decoders and the GF(2) kernels they build on
+ * Decoders are benchmarked on the toric, hypergraph product and lifted product codes in examples/ over a grid of
+ * physical error rates, one benchmark per decoder, growth variant, code and rate. UFHeuristic+LUT consults a lookup table of
+ * the syndromes of errors of weight at most 2 before growing clusters.
+ * The union find structures are benchmarked by replaying cluster growth on the Tanner graphs of toric codes, comparing
+ * the previous find (no compression, union by size), TreeNode and the UnionFindArena, with the find depths as counters.
+ * Results are printed to the console and written as json to qecc_bench.json unless --benchmark_out is given, e.g.
+ *   qecc_bench --benchmark_filter=UFHeuristic --benchmark_out=baseline.json
+ * Samples are drawn from fixed seeds, so runs on the same machine are comparable
+ */
+#include "Code.hpp"
+#include "RandomStream.hpp"
+#include "SyndromeLookupTable.hpp"
+#include "TreeNode.hpp"
+#include "UFDecoder.hpp"
+#include "UFHeuristic.hpp"
+#include "UnionFindArena.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr std::uint64_t         SEED         = 42U;
+constexpr std::size_t           NR_SYNDROMES = 256U; // decoded round robin, sampled before timing starts
+constexpr const char*           EXAMPLES_DIR = QECC_EXAMPLES_DIR;
+constexpr std::array<double, 3> ERROR_RATES  = {0.01, 0.03, 0.05};
+constexpr std::array            KERNEL_CODES = {"toric_512", "hgp_900", "lp_1024"};
+constexpr std::array<std::size_t, 5> UF_DISTANCES       = {16, 32, 64, 128, 256};
+constexpr std::size_t                NR_FINDS_PER_UNION = 4U;
+
+struct BenchCode {
+    std::string                 name;
+    std::shared_ptr<const Code> code;
+};
+
+/**
+ * Single-sided codes, the decoders correct X errors with hZ
+ */
+std::vector<BenchCode> loadCodes() {
+    const std::vector<std::pair<std::string, std::string>> files = {
+            {"toric_200", "toric/toric_(nan,nan)-[[200,2,10]]_hx.txt"},
+            {"toric_512", "toric/toric_(nan,nan)-[[512,2,16]]_hx.txt"},
+            {"toric_1058", "toric/toric_(nan,nan)-[[1058,2,23]]_hx.txt"},
+            {"hgp_900", "test/hgp_(4,7)-[[900,36,10]]_hz.txt"},
+            {"lp_1024", "lp_(4,8)-[[1024,18,nan]]_hz.txt"}};
+    std::vector<BenchCode> codes;
+    for (const auto& [name, file] : files) {
+        codes.push_back({name, std::make_shared<const Code>(std::string(EXAMPLES_DIR) + file)});
+    }
+    return codes;
+}
+
+const BenchCode& findCode(const std::vector<BenchCode>& codes, const std::string_view name) {
+    for (const auto& c : codes) {
+        if (c.name == name) {
+            return c;
+        }
+    }
+    throw QeccException("Unknown benchmark code");
+}
+
+std::vector<gf2Vec> sampleErrors(const Code& code, const double physicalErrRate, const std::size_t nrErrors) {
+    RandomStream        gen(SEED, 0U);
+    std::vector<gf2Vec> errors;
+    errors.reserve(nrErrors);
+    for (std::size_t i = 0; i < nrErrors; i++) {
+        errors.emplace_back(Utils::sampleErrorIidPauliNoise(code.getN(), physicalErrRate, gen));
+    }
+    return errors;
+}
+
+template <class D>
+void decodeBenchmark(benchmark::State& state, const std::shared_ptr<const Code>& code, const GrowthVariant growth, const double physicalErrRate,
+                     const bool withLookupTable) {
+    std::vector<gf2Vec> syndromes;
+    for (const auto& err : sampleErrors(*code, physicalErrRate, NR_SYNDROMES)) {
+        syndromes.emplace_back(code->getXSyndrome(err));
+    }
+    D decoder;
+    decoder.setCode(code);
+    if (withLookupTable) {
+        // built before timing starts, as at load time
+        decoder.setLookupTable(std::make_shared<const SyndromeLookupTable>(*code->gethZ()));
+    }
+    std::size_t i = 0U;
+    for (auto _ : state) { // NOLINT(readability-identifier-length)
+        decoder.reset();
+        decoder.setGrowth(growth);
+        decoder.decode(syndromes[i++ % NR_SYNDROMES]);
+        benchmark::DoNotOptimize(decoder.result.estimNodeIdxVector.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["n"] = static_cast<double>(code->getN());
+    state.counters["p"] = physicalErrRate;
+}
+
+void solveSystemBenchmark(benchmark::State& state, const std::shared_ptr<const Code>& code) {
+    // right hand sides in the column space, so that every system is solvable
+    std::vector<gf2Vec> syndromes;
+    for (const auto& err : sampleErrors(*code, 0.05, NR_SYNDROMES)) {
+        syndromes.emplace_back(code->getXSyndrome(err));
+    }
+    const auto& pcm = *code->gethZ()->pcm;
+    std::size_t i   = 0U;
+    for (auto _ : state) { // NOLINT(readability-identifier-length)
+        auto res = Utils::solveSystem(pcm, Gf2Vector(syndromes[i++ % NR_SYNDROMES]));
+        benchmark::DoNotOptimize(res);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void rowspaceBenchmark(benchmark::State& state, const std::shared_ptr<const Code>& code) {
+    // half of the vectors are stabilizers, that is sums of rows, the others are random errors
+    const auto&         pcm = *code->gethZ()->pcm;
+    RandomStream        gen(SEED, 1U);
+    std::vector<gf2Vec> vectors = sampleErrors(*code, 0.05, NR_SYNDROMES);
+    for (std::size_t v = 0; v < NR_SYNDROMES; v += 2) {
+        Gf2Vector stabilizer(pcm.cols());
+        for (std::size_t r = 0; r < pcm.rows(); r++) {
+            if ((gen() & 1U) != 0U) {
+                stabilizer ^= pcm.row(r);
+            }
+        }
+        vectors[v] = stabilizer.toBoolVector();
+    }
+    std::size_t i = 0U;
+    for (auto _ : state) { // NOLINT(readability-identifier-length)
+        benchmark::DoNotOptimize(Utils::isVectorInRowspace(pcm, vectors[i++ % NR_SYNDROMES]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void syndromeBenchmark(benchmark::State& state, const std::shared_ptr<const Code>& code) {
+    const auto  errors = sampleErrors(*code, 0.05, NR_SYNDROMES);
+    std::size_t i      = 0U;
+    for (auto _ : state) { // NOLINT(readability-identifier-length)
+        auto syndrome = code->getXSyndrome(errors[i++ % NR_SYNDROMES]);
+        benchmark::DoNotOptimize(syndrome);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void samplingBenchmark(benchmark::State& state, const std::size_t n, const double physicalErrRate) {
+    for (auto _ : state) { // NOLINT(readability-identifier-length)
+        auto err = Utils::sampleErrorIidPauliNoise(n, physicalErrRate);
+        benchmark::DoNotOptimize(err);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+struct UnionFindWorkload {
+    std::size_t                                      nrNodes = 0U;
+    std::vector<std::pair<std::size_t, std::size_t>> unions;
+    std::vector<std::size_t>                         finds; // NR_FINDS_PER_UNION finds after each union
+};
+
+/**
+ * Tanner graph edges of the toric code with distance l in random order, bits 0..2l^2-1, checks after
+ */
+UnionFindWorkload toricWorkload(const std::size_t l) {
+    UnionFindWorkload w;
+    const auto        nrBits = 2 * l * l;
+    w.nrNodes                = nrBits + l * l;
+    for (std::size_t i = 0; i < l; i++) {
+        for (std::size_t j = 0; j < l; j++) {
+            const auto check = nrBits + i * l + j;
+            const auto right = nrBits + i * l + (j + 1) % l;
+            const auto down  = nrBits + ((i + 1) % l) * l + j;
+            const auto hEdge = i * l + j;
+            const auto vEdge = l * l + i * l + j;
+            w.unions.emplace_back(check, hEdge);
+            w.unions.emplace_back(hEdge, right);
+            w.unions.emplace_back(check, vEdge);
+            w.unions.emplace_back(vEdge, down);
+        }
+    }
+    std::mt19937_64 gen(SEED);
+    std::shuffle(w.unions.begin(), w.unions.end(), gen);
+    std::uniform_int_distribution<std::size_t> d(0U, w.nrNodes - 1);
+    w.finds.resize(w.unions.size() * NR_FINDS_PER_UNION);
+    for (auto& f : w.finds) {
+        f = d(gen);
+    }
+    return w;
+}
+
+/**
+ * Previous behaviour of TreeNode: walk to the root without rewriting parents, attach the smaller cluster
+ */
+struct LegacyUnionFind {
+    std::vector<std::size_t> parent;
+    std::vector<std::size_t> clusterSize;
+
+    explicit LegacyUnionFind(const std::size_t n) : parent(n), clusterSize(n, 1U) {
+        for (std::size_t i = 0; i < n; i++) {
+            parent[i] = i;
+        }
+    }
+    [[nodiscard]] std::size_t find(std::size_t v) const {
+        while (parent[v] != v) {
+            v = parent[v];
+        }
+        return v;
+    }
+    [[nodiscard]] std::size_t depth(std::size_t v) const {
+        std::size_t d = 0U;
+        while (parent[v] != v) {
+            v = parent[v];
+            d++;
+        }
+        return d;
+    }
+    void unite(const std::size_t a, const std::size_t b) {
+        const auto r1 = find(a);
+        const auto r2 = find(b);
+        if (r1 == r2) {
+            return;
+        }
+        if (clusterSize[r1] <= clusterSize[r2]) {
+            parent[r1] = r2;
+            clusterSize[r2] += clusterSize[r1];
+        } else {
+            parent[r2] = r1;
+            clusterSize[r1] += clusterSize[r2];
+        }
+    }
+};
+
+struct TreeNodeUnionFind {
+    std::vector<std::unique_ptr<TreeNode>> nodes;
+
+    explicit TreeNodeUnionFind(const std::size_t n) {
+        for (std::size_t i = 0; i < n; i++) {
+            nodes.emplace_back(std::make_unique<TreeNode>(i));
+        }
+    }
+    std::size_t find(const std::size_t v) {
+        return TreeNode::Find(nodes[v].get())->vertexIdx;
+    }
+    [[nodiscard]] std::size_t depth(const std::size_t v) const {
+        std::size_t d    = 0U;
+        const auto* node = nodes[v].get();
+        while (node->parent != nullptr) {
+            node = node->parent;
+            d++;
+        }
+        return d;
+    }
+    void unite(const std::size_t a, const std::size_t b) {
+        TreeNode::Union(nodes[a].get(), nodes[b].get());
+    }
+};
+
+struct ArenaUnionFind {
+    UnionFindArena arena;
+
+    explicit ArenaUnionFind(const std::size_t n) : arena(n) {}
+    std::size_t find(const std::size_t v) {
+        return arena.find(v);
+    }
+    [[nodiscard]] std::size_t depth(const std::size_t v) const {
+        return arena.depth(v);
+    }
+    void unite(const std::size_t a, const std::size_t b) {
+        arena.unite(arena.find(a), arena.find(b));
+    }
+};
+
+template <class UF>
+void unionFindBenchmark(benchmark::State& state, const std::size_t l) {
+    const auto w = toricWorkload(l);
+    // depths are recorded in a separate pass so that they do not disturb the timing
+    std::size_t depthSum = 0U;
+    std::size_t maxDepth = 0U;
+    {
+        UF uf(w.nrNodes);
+        for (std::size_t u = 0; u < w.unions.size(); u++) {
+            uf.unite(w.unions[u].first, w.unions[u].second);
+            for (std::size_t f = 0; f < NR_FINDS_PER_UNION; f++) {
+                const auto v = w.finds[u * NR_FINDS_PER_UNION + f];
+                const auto d = uf.depth(v);
+                maxDepth     = std::max(maxDepth, d);
+                depthSum += d;
+                static_cast<void>(uf.find(v));
+            }
+        }
+    }
+    std::optional<UF> uf;
+    for (auto _ : state) { // NOLINT(readability-identifier-length)
+        // construction and destruction of the previous structure are not timed
+        state.PauseTiming();
+        uf.emplace(w.nrNodes);
+        state.ResumeTiming();
+        for (std::size_t u = 0; u < w.unions.size(); u++) {
+            uf->unite(w.unions[u].first, w.unions[u].second);
+            for (std::size_t f = 0; f < NR_FINDS_PER_UNION; f++) {
+                benchmark::DoNotOptimize(uf->find(w.finds[u * NR_FINDS_PER_UNION + f]));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(w.finds.size()));
+    state.counters["avgDepth"] = static_cast<double>(depthSum) / static_cast<double>(w.finds.size());
+    state.counters["maxDepth"] = static_cast<double>(maxDepth);
+}
+
+std::string growthName(const GrowthVariant growth) {
+    switch (growth) {
+        case GrowthVariant::AllComponents:
+            return "ALL_COMPONENTS";
+        case GrowthVariant::InvalidComponents:
+            return "INVALID_COMPONENTS";
+        case GrowthVariant::SingleSmallest:
+            return "SINGLE_SMALLEST";
+        case GrowthVariant::SingleRandom:
+            return "SINGLE_RANDOM";
+        case GrowthVariant::SingleQubitRandom:
+            return "SINGLE_QUBIT_RANDOM";
+        case GrowthVariant::Weighted:
+            return "WEIGHTED";
+    }
+    return "";
+}
+
+std::string rateName(const double physicalErrRate) {
+    return "p=" + std::to_string(physicalErrRate).substr(0, 4);
+}
+
+void registerBenchmarks(const std::vector<BenchCode>& codes) {
+    // UFHeuristic does not implement SingleQubitRandom, its weighted growth uses uniform weights here.
+    // UFDecoder does not implement InvalidComponents and Weighted, its SingleQubitRandom
+    // grows around an arbitrary node of a cluster, which stalls once that node is interior, so neither would terminate
+    const std::vector<GrowthVariant> heuristicGrowths = {GrowthVariant::AllComponents, GrowthVariant::InvalidComponents,
+                                                         GrowthVariant::SingleSmallest, GrowthVariant::SingleRandom,
+                                                         GrowthVariant::Weighted};
+    const std::vector<GrowthVariant> originalGrowths  = {GrowthVariant::AllComponents, GrowthVariant::SingleSmallest,
+                                                         GrowthVariant::SingleRandom};
+    for (const auto& [name, code] : codes) {
+        for (const auto p : ERROR_RATES) {
+            for (const auto growth : heuristicGrowths) {
+                benchmark::RegisterBenchmark(("UFHeuristic/" + name + "/" + growthName(growth) + "/" + rateName(p)).c_str(),
+                                             decodeBenchmark<UFHeuristic>, code, growth, p, false);
+            }
+            benchmark::RegisterBenchmark(("UFHeuristic+LUT/" + name + "/" + growthName(GrowthVariant::AllComponents) + "/" + rateName(p)).c_str(),
+                                         decodeBenchmark<UFHeuristic>, code, GrowthVariant::AllComponents, p, true);
+            for (const auto growth : originalGrowths) {
+                benchmark::RegisterBenchmark(("UFDecoder/" + name + "/" + growthName(growth) + "/" + rateName(p)).c_str(),
+                                             decodeBenchmark<UFDecoder>, code, growth, p, false)
+                        ->Unit(benchmark::kMicrosecond);
+            }
+        }
+    }
+    for (const auto& name : KERNEL_CODES) {
+        const auto& code = findCode(codes, name).code;
+        benchmark::RegisterBenchmark(("solveSystem/" + std::string(name)).c_str(), solveSystemBenchmark, code);
+        benchmark::RegisterBenchmark(("isVectorInRowspace/" + std::string(name)).c_str(), rowspaceBenchmark, code);
+        benchmark::RegisterBenchmark(("getXSyndrome/" + std::string(name)).c_str(), syndromeBenchmark, code);
+        for (const auto p : ERROR_RATES) {
+            benchmark::RegisterBenchmark(("sampleErrorIidPauliNoise/" + std::string(name) + "/" + rateName(p)).c_str(), samplingBenchmark, code->getN(), p);
+        }
+    }
+    for (const auto l : UF_DISTANCES) {
+        const auto suffix = "/toric_l=" + std::to_string(l);
+        benchmark::RegisterBenchmark(("UnionFind/legacy" + suffix).c_str(), unionFindBenchmark<LegacyUnionFind>, l)->Unit(benchmark::kMicrosecond);
+        benchmark::RegisterBenchmark(("UnionFind/TreeNode" + suffix).c_str(), unionFindBenchmark<TreeNodeUnionFind>, l)->Unit(benchmark::kMicrosecond);
+        benchmark::RegisterBenchmark(("UnionFind/UnionFindArena" + suffix).c_str(), unionFindBenchmark<ArenaUnionFind>, l)->Unit(benchmark::kMicrosecond);
+    }
+}
+} // namespace
+
+int main(int argc, char* argv[]) { // NOLINT(bugprone-exception-escape)
+    // write json next to the console output unless the caller chose an output file
+    std::vector<char*> args(argv, argv + argc); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    std::string        outArg    = "--benchmark_out=qecc_bench.json";
+    std::string        formatArg = "--benchmark_out_format=json";
+    const bool         hasOut    = std::any_of(args.begin(), args.end(), [](const char* a) { return std::string(a).rfind("--benchmark_out=", 0) == 0; });
+    if (!hasOut) {
+        args.emplace_back(outArg.data());
+        args.emplace_back(formatArg.data());
+    }
+    auto nrArgs = static_cast<int>(args.size());
+    benchmark::Initialize(&nrArgs, args.data());
+    if (benchmark::ReportUnrecognizedArguments(nrArgs, args.data())) {
+        return 1;
+    }
+    registerBenchmarks(loadCodes());
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,57 @@
+"""Test reading columnar simulation results."""
+
+from __future__ import annotations
+
+import json
+from typing import TYPE_CHECKING
+
+import numpy as np
+import pytest
+
+from mqt.qecc import load_results
+
+if TYPE_CHECKING:
+    from pathlib import Path
+
+
+def _write_columns(path: Path, syndromes: list[list[int]], finished: bool = True) -> None:
+    n = len(syndromes)
+    path.mkdir()
+    np.full(n, 0.01, dtype="<f8").tofile(path / "p.f64")
+    np.zeros(n, dtype="<u4").tofile(path / "code.u32")
+    np.array([i % 2 for i in range(n)], dtype="u1").tofile(path / "status.u8")
+    np.arange(n, dtype="<u8").tofile(path / "latency_ns.u64")
+    offsets = np.cumsum([0] + [len(s) for s in syndromes]).astype("<u8")
+    offsets.tofile(path / "syndrome_offsets.u64")
+    np.array([i for s in syndromes for i in s], dtype="<u4").tofile(path / "syndrome_indices.u32")
+    np.zeros(n + 1, dtype="<u8").tofile(path / "estimate_offsets.u64")
+    (path / "estimate_indices.u32").touch()
+    if finished:
+        (path / "meta.json").write_text(json.dumps({"format": "mqt-qecc-columnar", "version": 1, "records": n}))
+
+
+def test_load_results(tmp_path: Path) -> None:
+    """Test that columns are mapped and sparse vectors are recovered per shot."""
+    _write_columns(tmp_path / "res", [[1, 4], [], [2]])
+    res = load_results(tmp_path / "res")
+    assert len(res) == 3
+    assert list(res.syndrome(0)) == [1, 4]
+    assert len(res.syndrome(1)) == 0
+    assert list(res.syndrome(2)) == [2]
+    assert len(res.estimate(2)) == 0
+    assert int(res.failed().sum()) == 1
+    assert isinstance(res.latency_ns, np.memmap)
+
+
+def test_load_unfinished_results(tmp_path: Path) -> None:
+    """Test that results of an interrupted simulation can be read."""
+    _write_columns(tmp_path / "res", [[0], [3]], finished=False)
+    assert len(load_results(tmp_path / "res")) == 2
+
+
+def test_load_results_version(tmp_path: Path) -> None:
+    """Test that unknown formats are rejected."""
+    _write_columns(tmp_path / "res", [[0]])
+    (tmp_path / "res" / "meta.json").write_text(json.dumps({"format": "mqt-qecc-columnar", "version": 2, "records": 1}))
+    with pytest.raises(ValueError, match="Unsupported"):
+        load_results(tmp_path / "res")
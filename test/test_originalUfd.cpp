@@ -146,4 +146,94 @@ TEST_P(UpToStabCorrectableErrTestOriginal, SteaneCodeDecodingTest) {
     EXPECT_TRUE(Utils::isVectorInRowspace(*code.gethX()->pcm, residualErr));
     EXPECT_TRUE(Utils::isVectorInRowspace(*code.gethX()->pcm, residualErr2));
 }
+
+/**
+ * Decoders share one code handle and are reused across shots
+ */
+TEST_P(UniquelyCorrectableErrTestOriginal, SharedCodeReusedDecoder) {
+    const auto code = std::make_shared<const Code>(SteaneXCode());
+    UFDecoder  decoder;
+    UFDecoder  decoder2;
+    decoder.setCode(code);
+    decoder2.setCode(code);
+    EXPECT_EQ(decoder.getCode().get(), decoder2.getCode().get());
+
+    const std::vector<bool> err   = GetParam();
+    const auto              syndr = code->getXSyndrome(err);
+    for (std::size_t i = 0; i < 2; i++) {
+        decoder.reset();
+        decoder.decode(syndr);
+        EXPECT_TRUE(decoder.result.estimBoolVector == err);
+    }
+}
+TEST_F(OriginalUFDtest, PhaseTimings) {
+    auto      code = SteaneXCode();
+    UFDecoder decoder;
+    decoder.setCode(code);
+    const std::vector<bool> err{1, 0, 0, 0, 0, 0, 0};
+    decoder.decode(code.getXSyndrome(err));
+    const auto& res = decoder.result;
+    EXPECT_GT(res.decodingNanos, 0U);
+    EXPECT_LE(res.phaseNanos.total(), res.decodingNanos);
+    if (PHASE_TIMING_ENABLED) {
+        EXPECT_GT(res.phaseNanos[DecodingPhase::ValidityCheck], 0U);
+        EXPECT_EQ(res.phaseNanos[DecodingPhase::Fusion], 0U);
+    } else {
+        EXPECT_EQ(res.phaseNanos.total(), 0U);
+    }
+}
+/**
+ * Growth of a single cluster computes the connected components of the grown set in every step, all errors of weight up to two
+ * have to end in an estimate with the same syndrome
+ */
+TEST_F(OriginalUFDtest, SingleClusterGrowth) {
+    auto      code = SteaneXCode();
+    UFDecoder decoder;
+    decoder.setCode(code);
+    for (const auto growth : {GrowthVariant::SingleSmallest, GrowthVariant::SingleRandom}) {
+        for (std::size_t i = 0; i < code.getN(); i++) {
+            for (std::size_t j = i; j < code.getN(); j++) {
+                std::vector<bool> err(code.getN());
+                err.at(i)        = true;
+                err.at(j)        = true;
+                const auto syndr = code.getXSyndrome(err);
+                decoder.reset();
+                decoder.setGrowth(growth);
+                decoder.decode(syndr);
+                EXPECT_EQ(code.getXSyndrome(decoder.result.estimBoolVector), syndr);
+            }
+        }
+    }
+}
+/**
+ * The random growth variants pick one of the components, a syndrome with a single component must always pick that one
+ */
+TEST_F(OriginalUFDtest, SingleQubitRandomGrowth) {
+    auto      code = SteaneXCode();
+    UFDecoder decoder;
+    decoder.setCode(code);
+    const std::vector<bool> err{1, 0, 0, 0, 0, 0, 0};
+    const auto              syndr = code.getXSyndrome(err);
+    for (std::size_t i = 0; i < 32; i++) {
+        decoder.reset();
+        decoder.setGrowth(GrowthVariant::SingleQubitRandom);
+        decoder.decode(syndr);
+        EXPECT_TRUE(decoder.result.estimBoolVector == err);
+    }
+}
+/**
+ * Syndromes of single-bit errors are answered by the lookup table, the correction of the Steane code is unique
+ */
+TEST_P(UniquelyCorrectableErrTestOriginal, LookupTable) {
+    const auto code  = std::make_shared<const Code>(SteaneXCode());
+    const auto table = std::make_shared<const SyndromeLookupTable>(*code->gethZ(), LookupTableConfig{1U});
+    UFDecoder  decoder;
+    decoder.setCode(code);
+    decoder.setLookupTable(table);
+    const std::vector<bool> err = GetParam();
+    decoder.decode(code->getXSyndrome(err));
+    EXPECT_TRUE(decoder.result.estimBoolVector == err);
+    decoder.setCode(code);
+    EXPECT_EQ(decoder.getLookupTable(), nullptr);
+}
 // NOLINTEND(readability-implicit-bool-conversion,modernize-use-bool-literals)
@@ -2,12 +2,21 @@
 // Created by luca on 09/08/22.
 //
 #include "Codes.hpp"
+#include "BoundedQueue.hpp"
 #include "DecodingSimulator.hpp"
+#include "LatencyHistogram.hpp"
+#include "RandomStream.hpp"
+#include "ResultsSink.hpp"
 #include "UFDecoder.hpp"
 
+#include <algorithm>
 #include <bitset>
+#include <cstring>
+#include <ctime>
 #include <fstream>
 #include <gtest/gtest.h>
+#include <iomanip>
+#include <thread>
 using json = nlohmann::json;
 class DecodingSimulatorTest : public testing::TestWithParam<std::string> {
 };
@@ -47,3 +56,356 @@ TEST(DecodingSimulatorTest, TestPerformanceSim) {
     }
     EXPECT_TRUE(true);
 }
+
+TEST(DecodingSimulatorTest, TestParallelSimSeedReproducible) {
+    const auto readRaw = [](const std::string& prefix) {
+        auto               t  = std::time(nullptr);
+        auto               tm = *std::localtime(&t);
+        std::ostringstream oss;
+        oss << prefix << "-" << std::put_time(&tm, "%d-%m-%Y") << ".json";
+        std::ifstream in(oss.str());
+        return json::parse(in);
+    };
+    const std::string rawSeq   = "./testRawFileSeq";
+    const std::string rawPar   = "./testRawFilePar";
+    const double      minErate = 0.05;
+    const double      maxErate = 0.2;
+    const double      stepSize = 0.05;
+    // several batches per rate so that they are spread over the threads
+    const std::size_t   runsPerRate = 300;
+    const std::uint64_t seed        = 42U;
+    auto                code        = SteaneCode();
+    DecodingSimulator::simulateWER(rawSeq, "", minErate, maxErate, runsPerRate, code, stepSize, DecoderType::UfHeuristic, 1U, seed);
+    DecodingSimulator::simulateWER(rawPar, "", minErate, maxErate, runsPerRate, code, stepSize, DecoderType::UfHeuristic, 4U, seed);
+    const auto seq = readRaw(rawSeq);
+    const auto par = readRaw(rawPar);
+    EXPECT_FALSE(seq.empty());
+    EXPECT_EQ(seq, par);
+}
+
+TEST(DecodingSimulatorTest, TestWilsonInterval) {
+    // 10 failures in 100 shots at 95% confidence
+    const auto [lower, upper] = DecodingSimulator::wilsonInterval(10U, 100U, 1.96);
+    EXPECT_NEAR(lower, 0.0552, 1e-3);
+    EXPECT_NEAR(upper, 0.1744, 1e-3);
+    // no failures still gives a nontrivial upper bound
+    const auto [zeroLower, zeroUpper] = DecodingSimulator::wilsonInterval(0U, 1000U, 1.96);
+    EXPECT_EQ(zeroLower, 0.0);
+    EXPECT_NEAR(zeroUpper, 0.0038, 1e-4);
+}
+
+TEST(DecodingSimulatorTest, TestAdaptiveSim) {
+    auto             code = SteaneCode();
+    StoppingCriteria criteria;
+    criteria.targetFailures = 50U;
+    criteria.maxShots       = 20000U;
+    const auto estimates    = DecodingSimulator::simulateWERAdaptive("", 0.01, 0.2, 0.09, code, DecoderType::UfHeuristic, criteria, 2U, 7U);
+    ASSERT_EQ(estimates.size(), 3U);
+    for (const auto& est : estimates) {
+        EXPECT_TRUE(est.failures >= criteria.targetFailures || est.shots == criteria.maxShots);
+        EXPECT_LE(est.shots, criteria.maxShots);
+        EXPECT_LE(est.lower, est.wordErrRate);
+        EXPECT_GE(est.upper, est.wordErrRate);
+    }
+    // high error rates reach the failure target with fewer shots
+    EXPECT_LT(estimates.back().shots, estimates.front().shots);
+
+    // independent of the number of threads for a fixed seed
+    const auto sequential = DecodingSimulator::simulateWERAdaptive("", 0.01, 0.2, 0.09, code, DecoderType::UfHeuristic, criteria, 1U, 7U);
+    for (std::size_t i = 0; i < estimates.size(); i++) {
+        EXPECT_EQ(estimates[i].shots, sequential[i].shots);
+        EXPECT_EQ(estimates[i].failures, sequential[i].failures);
+    }
+
+    criteria.targetFailures = 0U;
+    criteria.maxShots       = 0U;
+    EXPECT_THROW(static_cast<void>(DecodingSimulator::simulateWERAdaptive("", 0.01, 0.02, 0.01, code, DecoderType::UfHeuristic, criteria)), QeccException);
+}
+
+TEST(DecodingSimulatorTest, TestStratifiedSim) {
+    auto code = SteaneCode();
+    // all 128 errors are enumerated, the estimate is exact
+    const auto exact = DecodingSimulator::simulateWERStratified("", {}, code, DecoderType::UfHeuristic, 7U, 0U);
+    ASSERT_EQ(exact.strata.size(), 8U);
+    EXPECT_TRUE(std::all_of(exact.strata.begin(), exact.strata.end(), [](const WeightStratum& s) { return s.exact; }));
+    EXPECT_EQ(exact.strata[0].failures, 0U);
+    EXPECT_EQ(exact.strata[1].shots, 7U);
+    EXPECT_EQ(exact.strata[2].shots, 21U);
+    const auto exactEst = exact.estimate(0.1);
+    EXPECT_DOUBLE_EQ(exactEst.lower, exactEst.wordErrRate);
+    EXPECT_DOUBLE_EQ(exactEst.upper, exactEst.wordErrRate);
+    double mass = 0.0;
+    for (std::size_t w = 0; w <= 7U; w++) {
+        mass += exact.binomialWeight(w, 0.1);
+    }
+    EXPECT_NEAR(mass, 1.0, 1e-12);
+
+    // weight 2 and above are sampled, the tail above weight 4 is only bounded
+    const auto sampled = DecodingSimulator::simulateWERStratified("", {}, code, DecoderType::UfHeuristic, 4U, 2000U, 10U, 2U, 3U);
+    ASSERT_EQ(sampled.strata.size(), 5U);
+    EXPECT_TRUE(sampled.strata[1].exact);
+    EXPECT_FALSE(sampled.strata[2].exact);
+    EXPECT_EQ(sampled.strata[2].shots, 2000U);
+    for (const auto p : {0.01, 0.05, 0.1}) {
+        const auto est = sampled.estimate(p);
+        EXPECT_LE(est.lower, est.wordErrRate);
+        EXPECT_GE(est.upper, est.wordErrRate);
+        const auto reference = exact.estimate(p).wordErrRate;
+        EXPECT_LE(est.lower, reference);
+        EXPECT_GE(est.upper, reference);
+    }
+    // independent of the number of threads
+    const auto sequential = DecodingSimulator::simulateWERStratified("", {}, code, DecoderType::UfHeuristic, 4U, 2000U, 10U, 1U, 3U);
+    for (std::size_t w = 0; w < sampled.strata.size(); w++) {
+        EXPECT_EQ(sampled.strata[w].failures, sequential.strata[w].failures);
+    }
+}
+
+TEST(DecodingSimulatorTest, TestCoupledSim) {
+    // errors at smaller rates are subsets of those at larger rates
+    RandomStream gen(5U, 0U);
+    const auto   flips = Utils::sampleCoupledErrorIidPauliNoise(100000, 0.02, gen);
+    EXPECT_TRUE(std::is_sorted(flips.begin(), flips.end()));
+    const auto below = std::count_if(flips.begin(), flips.end(), [](const auto& f) { return f.first < 0.01; });
+    EXPECT_NEAR(static_cast<double>(flips.size()), 2000.0, 200.0);
+    EXPECT_NEAR(static_cast<double>(below), 1000.0, 150.0);
+
+    auto       code      = SteaneCode();
+    const auto estimates = DecodingSimulator::simulateWERCoupled("", 0.0, 0.2, 0.05, 500U, code, DecoderType::UfHeuristic, 3U, 11U);
+    ASSERT_EQ(estimates.size(), 4U);
+    EXPECT_EQ(estimates.front().failures, 0U);
+    for (const auto& est : estimates) {
+        EXPECT_EQ(est.shots, 500U);
+        EXPECT_LE(est.lower, est.wordErrRate);
+        EXPECT_GE(est.upper, est.wordErrRate);
+    }
+    EXPECT_LT(estimates[1].failures, estimates[3].failures);
+
+    const auto sequential = DecodingSimulator::simulateWERCoupled("", 0.0, 0.2, 0.05, 500U, code, DecoderType::UfHeuristic, 1U, 11U);
+    for (std::size_t i = 0; i < estimates.size(); i++) {
+        EXPECT_EQ(estimates[i].failures, sequential[i].failures);
+    }
+}
+
+TEST(DecodingSimulatorTest, TestPhenomenologicalSim) {
+    auto       code      = SteaneCode();
+    const auto estimates = DecodingSimulator::simulateWERPhenomenological("", 0.0, 0.1, 0.05, 300U, code, DecoderType::UfHeuristic, 3U, std::nullopt, 3U, 13U);
+    ASSERT_EQ(estimates.size(), 2U);
+    EXPECT_EQ(estimates.front().failures, 0U);
+    for (const auto& est : estimates) {
+        EXPECT_EQ(est.shots, 300U);
+        EXPECT_LE(est.lower, est.wordErrRate);
+        EXPECT_GE(est.upper, est.wordErrRate);
+    }
+    EXPECT_GT(estimates.back().failures, 0U);
+
+    const auto sequential = DecodingSimulator::simulateWERPhenomenological("", 0.0, 0.1, 0.05, 300U, code, DecoderType::UfHeuristic, 3U, std::nullopt, 1U, 13U);
+    for (std::size_t i = 0; i < estimates.size(); i++) {
+        EXPECT_EQ(estimates[i].failures, sequential[i].failures);
+    }
+    // a single round has a perfect syndrome
+    const auto perfect = DecodingSimulator::simulateWERPhenomenological("", 0.0, 0.05, 0.05, 300U, code, DecoderType::UfHeuristic, 1U, 0.5, 1U, 13U);
+    EXPECT_EQ(perfect.front().failures, 0U);
+    EXPECT_THROW(DecodingSimulator::simulateWERPhenomenological("", 0.0, 0.1, 0.05, 10U, code, DecoderType::UfDecoder, 3U), QeccException);
+}
+
+TEST(DecodingSimulatorTest, TestCompareDecoders) {
+    auto                             code = SteaneCode();
+    const std::vector<DecoderConfig> configs{{DecoderType::UfHeuristic, GrowthVariant::AllComponents},
+                                             {DecoderType::UfDecoder, GrowthVariant::AllComponents},
+                                             {DecoderType::UfHeuristic, GrowthVariant::AllComponents},
+                                             {DecoderType::UfHeuristic, GrowthVariant::SingleSmallest}};
+    const auto                       res = DecodingSimulator::compareDecoders("", 0.1, 1000U, code, configs, 2U, 13U);
+    EXPECT_EQ(res.shots, 1000U);
+    EXPECT_GT(res.decoded, 0U);
+    ASSERT_EQ(res.failures.size(), configs.size());
+    // identical configurations decode identically
+    EXPECT_EQ(res.failures[0], res.failures[2]);
+    EXPECT_EQ(res.disagreements(0, 2), 0U);
+    for (std::size_t i = 0; i < configs.size(); i++) {
+        EXPECT_EQ(res.onlyFailed[i][i], 0U);
+        EXPECT_GT(res.meanLatencyNanos(i), 0.0);
+        for (std::size_t j = 0; j < configs.size(); j++) {
+            // paired counts are consistent with the marginal failures
+            EXPECT_EQ(res.failures[i] - res.onlyFailed[i][j], res.failures[j] - res.onlyFailed[j][i]);
+        }
+    }
+    const auto sequential = DecodingSimulator::compareDecoders("", 0.1, 1000U, code, configs, 1U, 13U);
+    EXPECT_EQ(res.failures, sequential.failures);
+    EXPECT_EQ(res.onlyFailed, sequential.onlyFailed);
+}
+
+TEST(DecodingSimulatorTest, TestBoundedQueue) {
+    EXPECT_THROW(BoundedQueue<int>(6U), QeccException);
+    BoundedQueue<std::size_t> queue(8U);
+    std::size_t               item = 0U;
+    EXPECT_FALSE(queue.tryPop(item));
+    for (std::size_t i = 0; i < 8U; i++) {
+        item = i;
+        EXPECT_TRUE(queue.tryPush(item));
+    }
+    item = 8U;
+    EXPECT_FALSE(queue.tryPush(item)); // full
+    for (std::size_t i = 0; i < 8U; i++) {
+        EXPECT_TRUE(queue.tryPop(item));
+        EXPECT_EQ(item, i);
+    }
+
+    // several producers, every item arrives exactly once
+    constexpr std::size_t    nrProducers = 4U;
+    constexpr std::size_t    nrItems     = 20000U;
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < nrProducers; p++) {
+        producers.emplace_back([&queue, p] {
+            for (std::size_t i = 0; i < nrItems; i++) {
+                auto value = p * nrItems + i;
+                while (!queue.tryPush(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::vector<bool> seen(nrProducers * nrItems, false);
+    for (std::size_t received = 0; received < nrProducers * nrItems;) {
+        if (queue.tryPop(item)) {
+            EXPECT_FALSE(seen[item]);
+            seen[item] = true;
+            received++;
+        }
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    EXPECT_FALSE(queue.tryPop(item));
+}
+
+TEST(DecodingSimulatorTest, TestAsyncNdjsonSink) {
+    const std::string path = "./testSinkFile.ndjson";
+    {
+        AsyncNdjsonSink sink(path, 16U);
+        for (std::uint32_t i = 0; i < 1000U; i++) {
+            ShotRecord record;
+            record.physicalErrRate = 0.5;
+            record.shot            = i;
+            record.status          = i % 3U == 0U ? FAILURE : SUCCESS;
+            record.error           = {i, i + 1U};
+            sink.write(std::move(record));
+        }
+        sink.close();
+        EXPECT_EQ(sink.nrWritten(), 1000U);
+    }
+    std::ifstream in(path);
+    std::string   line;
+    std::size_t   nrLines = 0U;
+    while (std::getline(in, line)) {
+        const auto record = json::parse(line);
+        const auto shot   = record["shot"].get<std::uint32_t>();
+        EXPECT_EQ(shot, nrLines);
+        EXPECT_EQ(record["status"], shot % 3U == 0U ? "failure" : "success");
+        EXPECT_EQ(record["error"], json::array({shot, shot + 1U}));
+        EXPECT_TRUE(record["estimate"].empty());
+        nrLines++;
+    }
+    EXPECT_EQ(nrLines, 1000U);
+}
+
+TEST(DecodingSimulatorTest, TestNdjsonErrRateRoundTrip) {
+    for (const double p : {1e-7, 1.234e-4, 0.1, 3.0e-9 / 7.0}) {
+        ShotRecord record;
+        record.physicalErrRate = p;
+        std::string line;
+        record.appendNdjson(line);
+        EXPECT_EQ(json::parse(line)["physicalErrRate"].get<double>(), p);
+    }
+}
+
+TEST(DecodingSimulatorTest, TestColumnarSink) {
+    const std::string dir = "./testSinkColumns";
+    {
+        AsyncColumnarSink sink(dir, 16U);
+        for (std::uint32_t i = 0; i < 100U; i++) {
+            ShotRecord record;
+            record.physicalErrRate = 0.25;
+            record.codeId          = 1U;
+            record.status          = i % 2U == 0U ? FAILURE : SUCCESS;
+            record.decodingNanos   = i;
+            record.syndrome        = std::vector<std::uint32_t>(i % 3U, i);
+            record.estimate        = {i};
+            sink.write(std::move(record));
+        }
+    }
+    const auto readColumn = [&dir](const std::string& name, const std::size_t itemSize) {
+        std::ifstream     in(dir + "/" + name, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        EXPECT_EQ(bytes.size() % itemSize, 0U);
+        return bytes;
+    };
+    const auto status  = readColumn("status.u8", 1U);
+    const auto p       = readColumn("p.f64", 8U);
+    const auto offsets = readColumn("syndrome_offsets.u64", 8U);
+    const auto indices = readColumn("syndrome_indices.u32", 4U);
+    ASSERT_EQ(status.size(), 100U);
+    EXPECT_EQ(p.size(), 800U);
+    EXPECT_EQ(status[0], 1);
+    EXPECT_EQ(status[1], 0);
+    ASSERT_EQ(offsets.size(), 101U * 8U);
+    std::vector<std::uint64_t> off(101U);
+    std::memcpy(off.data(), offsets.data(), offsets.size());
+    EXPECT_EQ(off[0], 0U);
+    EXPECT_EQ(off[3] - off[2], 2U); // record 2 has two syndrome indices
+    EXPECT_EQ(off[100] * 4U, indices.size());
+    std::uint32_t idx = 0U;
+    std::memcpy(&idx, indices.data() + off[2] * 4U, 4U);
+    EXPECT_EQ(idx, 2U);
+
+    std::ifstream metaIn(dir + "/meta.json");
+    const auto    meta = json::parse(metaIn);
+    EXPECT_EQ(meta["records"], 100U);
+}
+
+TEST(DecodingSimulatorTest, TestLatencyHistogram) {
+    // bucket boundaries are contiguous and cover each value
+    for (const std::uint64_t v : {0ULL, 1ULL, 127ULL, 128ULL, 129ULL, 255ULL, 256ULL, 1000ULL, 123456789ULL, ~0ULL}) {
+        const auto idx = LatencyHistogram::bucketIndex(v);
+        ASSERT_LT(idx, LatencyHistogram::NR_BUCKETS);
+        EXPECT_LE(LatencyHistogram::bucketLower(idx), v);
+        EXPECT_GE(LatencyHistogram::bucketUpper(idx), v);
+    }
+    for (std::size_t idx = 1; idx < LatencyHistogram::NR_BUCKETS; idx++) {
+        ASSERT_EQ(LatencyHistogram::bucketLower(idx), LatencyHistogram::bucketUpper(idx - 1) + 1);
+    }
+
+    // two halves recorded separately and merged equal the histogram of all values
+    LatencyHistogram first;
+    LatencyHistogram second;
+    LatencyHistogram all;
+    for (std::uint64_t v = 1; v <= 10000U; v++) {
+        (v % 2U == 0U ? first : second).record(v * 100U);
+        all.record(v * 100U);
+    }
+    first += second;
+    EXPECT_EQ(first.to_json(), all.to_json());
+    EXPECT_EQ(all.count(), 10000U);
+    EXPECT_EQ(all.min(), 100U);
+    EXPECT_EQ(all.max(), 1000000U);
+    EXPECT_DOUBLE_EQ(all.mean(), 500050.0);
+    // percentiles are exact up to the relative bucket width
+    const auto relErr = [](const std::uint64_t value, const double expected) { return std::abs(static_cast<double>(value) - expected) / expected; };
+    EXPECT_LT(relErr(all.valueAtPercentile(50.0), 500000.0), 0.02);
+    EXPECT_LT(relErr(all.valueAtPercentile(99.0), 990000.0), 0.02);
+    EXPECT_LT(relErr(all.valueAtPercentile(99.9), 999000.0), 0.02);
+    EXPECT_EQ(all.valueAtPercentile(100.0), all.max());
+    EXPECT_EQ(LatencyHistogram().valueAtPercentile(50.0), 0U);
+}
+
+TEST(DecodingSimulatorTest, TestRuntimeSimLatencies) {
+    const std::string codePath  = "./resources/codes/inCodes";
+    const auto        latencies = DecodingSimulator::simulateAverageRuntime("", "", 0.05, 2U, codePath, 20U, DecoderType::UfHeuristic, 2U, 7U, 10U);
+    ASSERT_FALSE(latencies.empty());
+    for (const auto& [path, latency] : latencies) {
+        // warm-up shots are not recorded
+        EXPECT_EQ(latency.count(), 40U);
+        EXPECT_LE(latency.min(), latency.valueAtPercentile(50.0));
+        EXPECT_LE(latency.valueAtPercentile(99.9), latency.max());
+    }
+}
@@ -3,7 +3,10 @@
 //
 
 #include "Codes.hpp"
+#include "StampedSet.hpp"
+#include "UnionFindArena.hpp"
 
+#include <algorithm>
 #include <gtest/gtest.h>
 
 class TreeNodeTest : public testing::TestWithParam<std::string> {};
@@ -149,3 +152,93 @@ TEST(TreeNodeTest, TestUnionThreeNodes) {
     TreeNode::Union(n3w, n4w);
     EXPECT_TRUE(TreeNode::Find(n3w) == TreeNode::Find(n4w));
 }
+
+TEST(TreeNodeTest, TestArenaUnionSplicesLists) {
+    UnionFindArena arena(5);
+    const auto     r1 = arena.unite(arena.find(0), arena.find(1));
+    const auto     r2 = arena.unite(arena.find(2), arena.find(3));
+    const auto     r  = arena.unite(r1, arena.find(4));
+    EXPECT_EQ(arena.find(4), r);
+    EXPECT_NE(arena.find(2), r);
+
+    const auto root = arena.unite(r, r2);
+    EXPECT_EQ(arena.getClusterSize(root), 5U);
+    std::vector<std::size_t> members;
+    arena.forEachMember(root, [&](const std::size_t v) { members.emplace_back(v); });
+    std::sort(members.begin(), members.end());
+    EXPECT_EQ(members, (std::vector<std::size_t>{0, 1, 2, 3, 4}));
+
+    arena.filterBoundary(root, [](const std::size_t v) { return v % 2 == 0; });
+    std::vector<std::size_t> bndry;
+    arena.forEachBoundaryVertex(root, [&](const std::size_t v) { bndry.emplace_back(v); });
+    std::sort(bndry.begin(), bndry.end());
+    EXPECT_EQ(bndry, (std::vector<std::size_t>{0, 2, 4}));
+    EXPECT_FALSE(arena.isBoundary(1));
+    EXPECT_TRUE(arena.isBoundary(4));
+}
+
+TEST(TreeNodeTest, TestArenaParity) {
+    UnionFindArena arena(5);
+    arena.flipParity(0);
+    arena.flipParity(2);
+    EXPECT_FALSE(arena.isNeutral(0));
+    EXPECT_TRUE(arena.isNeutral(1));
+    const auto r1 = arena.unite(arena.find(0), arena.find(1));
+    EXPECT_FALSE(arena.isNeutral(r1));
+    const auto r2 = arena.unite(r1, arena.find(2));
+    EXPECT_TRUE(arena.isNeutral(r2));
+    arena.flipParity(3);
+    arena.setOpen(4);
+    EXPECT_TRUE(arena.isNeutral(arena.unite(arena.find(3), arena.find(4))));
+    arena.reset(5);
+    arena.flipParity(3);
+    EXPECT_FALSE(arena.isNeutral(3));
+}
+
+TEST(TreeNodeTest, TestFindCompressesPath) {
+    auto n1    = std::make_unique<TreeNode>(0);
+    auto n2    = std::make_unique<TreeNode>(1);
+    auto n3    = std::make_unique<TreeNode>(2);
+    n3->parent = n2.get();
+    n2->parent = n1.get();
+
+    EXPECT_EQ(TreeNode::Find(n3.get()), n1.get());
+    EXPECT_EQ(n3->parent, n1.get());
+}
+
+TEST(TreeNodeTest, TestUnionByRank) {
+    std::vector<std::unique_ptr<TreeNode>> nodes;
+    for (std::size_t i = 0; i < 8; i++) {
+        nodes.emplace_back(std::make_unique<TreeNode>(i));
+    }
+    // merging equal sized trees doubles their size with every level, the rank stays logarithmic
+    for (std::size_t step = 1; step < nodes.size(); step *= 2) {
+        for (std::size_t i = 0; i + step < nodes.size(); i += 2 * step) {
+            TreeNode::Union(nodes[i].get(), nodes[i + step].get());
+        }
+    }
+    auto* root = TreeNode::Find(nodes[0].get());
+    EXPECT_EQ(root->rank, 3U);
+    EXPECT_EQ(root->clusterSize, 8U);
+    for (const auto& n : nodes) {
+        EXPECT_EQ(TreeNode::Find(n.get()), root);
+    }
+}
+
+TEST(TreeNodeTest, TestArenaResetOnlyInvalidates) {
+    UnionFindArena arena(4);
+    const auto     root = arena.unite(arena.find(0), arena.find(1));
+    arena.filterBoundary(root, [](const std::size_t) { return false; });
+    arena.reset(4);
+    EXPECT_EQ(arena.find(1), 1U);
+    EXPECT_EQ(arena.getClusterSize(0), 1U);
+    EXPECT_TRUE(arena.isBoundary(0));
+
+    StampedSet set(4);
+    set.insert(2);
+    set.insert(2);
+    EXPECT_EQ(set.size(), 1U);
+    set.clear();
+    EXPECT_FALSE(set.contains(2));
+    EXPECT_TRUE(set.empty());
+}
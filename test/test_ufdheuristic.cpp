@@ -5,9 +5,15 @@
 // NOLINTBEGIN(readability-implicit-bool-conversion,modernize-use-bool-literals)
 
 #include "Codes.hpp"
+#include "SlidingWindowDecoder.hpp"
+#include "SpaceTimeGraph.hpp"
 #include "UFHeuristic.hpp"
 
+#include <cstdio>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <iterator>
+#include <random>
 class ImprovedUFDtestBase : public testing::TestWithParam<std::vector<bool>> {};
 class UniquelyCorrectableErrTest : public ImprovedUFDtestBase {};
 class IncorrectableErrTest : public ImprovedUFDtestBase {};
@@ -19,21 +25,22 @@ INSTANTIATE_TEST_SUITE_P(CorrectableSingleBitErrs, UniquelyCorrectableErrTest,
                                  std::vector<bool>{0, 0, 0, 0, 0, 0, 0},
                                  std::vector<bool>{1, 0, 0, 0, 0, 0, 0},
                                  std::vector<bool>{0, 1, 0, 0, 0, 0, 0},
-                                 std::vector<bool>{0, 0, 1, 0, 0, 0, 0}));
-
-INSTANTIATE_TEST_SUITE_P(IncorrectableSingleBitErrs, IncorrectableErrTest,
-                         testing::Values(
+                                 std::vector<bool>{0, 0, 1, 0, 0, 0, 0},
                                  std::vector<bool>{0, 0, 0, 1, 0, 0, 0},
                                  std::vector<bool>{0, 0, 0, 0, 1, 0, 0},
                                  std::vector<bool>{0, 0, 0, 0, 0, 1, 0}));
 
-INSTANTIATE_TEST_SUITE_P(UptoStabCorrectable, UpToStabCorrectableErrTest,
+// the syndromes of these errors are those of a single bit, which is the estimate
+INSTANTIATE_TEST_SUITE_P(IncorrectableTwoBitErrs, IncorrectableErrTest,
                          testing::Values(
-                                 std::vector<bool>{0, 0, 0, 0, 0, 0, 1},
                                  std::vector<bool>{1, 1, 0, 0, 0, 0, 0},
                                  std::vector<bool>{0, 0, 0, 0, 1, 1, 0},
                                  std::vector<bool>{1, 0, 0, 0, 0, 0, 1}));
 
+INSTANTIATE_TEST_SUITE_P(UptoStabCorrectable, UpToStabCorrectableErrTest,
+                         testing::Values(
+                                 std::vector<bool>{0, 0, 0, 0, 0, 0, 1}));
+
 INSTANTIATE_TEST_SUITE_P(CorrectableLargeToricTests, CorrectableLargeToric,
                          testing::Values(
                                  std::vector<bool>{1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0}));
@@ -287,4 +294,280 @@ TEST_F(ImprovedUFDtestBase, BothErrsTest) {
         EXPECT_TRUE(false);
     }
 }
+TEST_F(ImprovedUFDtestBase, PhaseTimings) {
+    auto        code = HGPcode();
+    UFHeuristic decoder;
+    decoder.setCode(code);
+    auto err  = gf2Vec(code.n);
+    err.at(0) = 1;
+    decoder.decode(code.getXSyndrome(err));
+    const auto& res = decoder.result;
+    EXPECT_GT(res.decodingNanos, 0U);
+    EXPECT_EQ(res.decodingTime, res.decodingNanos / 1000000U);
+    // phases are disjoint parts of the decode, their sum cannot exceed the total
+    EXPECT_LE(res.phaseNanos.total(), res.decodingNanos);
+    if (PHASE_TIMING_ENABLED) {
+        EXPECT_GT(res.phaseNanos[DecodingPhase::Growth], 0U);
+        EXPECT_GT(res.phaseNanos[DecodingPhase::Solve], 0U);
+        EXPECT_TRUE(res.to_json().contains("phaseTimes(ns)"));
+    } else {
+        EXPECT_EQ(res.phaseNanos.total(), 0U);
+    }
+}
+/**
+ * The toric code is decoded by peeling, the estimate has to reproduce the syndrome of all errors of weight at most two
+ */
+TEST_F(ImprovedUFDtestBase, PeelingMatchesSyndrome) {
+    auto        code = ToricCode32();
+    UFHeuristic decoder;
+    decoder.setCode(code);
+    for (std::size_t i = 0; i < code.getN(); i++) {
+        for (std::size_t j = i; j < code.getN(); j++) {
+            auto err  = gf2Vec(code.getN());
+            err.at(i) = 1;
+            err.at(j) = 1;
+            decoder.reset();
+            decoder.decode(code.getXSyndrome(err));
+            EXPECT_EQ(code.getXSyndrome(decoder.result.estimBoolVector), code.getXSyndrome(err));
+        }
+    }
+}
+
+/**
+ * The hypergraph product code has bits of degree > 2, its clusters cannot be peeled and are solved by Gaussian elimination
+ */
+TEST_F(ImprovedUFDtestBase, SolveUnpeelableClusters) {
+    auto        code = HGPcode();
+    UFHeuristic decoder;
+    decoder.setCode(code);
+    for (std::size_t i = 0; i < code.getN(); i += 17) {
+        auto err  = gf2Vec(code.getN());
+        err.at(i) = 1;
+        decoder.reset();
+        decoder.decode(code.getXSyndrome(err));
+        EXPECT_EQ(code.getXSyndrome(decoder.result.estimBoolVector), code.getXSyndrome(err));
+    }
+}
+/**
+ * Single cluster growth leaves clusters of the hypergraph product code that are not solvable on their own, the part of the
+ * syndrome they leave unexplained is solved afterwards
+ */
+TEST_F(ImprovedUFDtestBase, UnsolvedClustersMatchSyndrome) {
+    auto                        code = HGPcode();
+    UFHeuristic                 decoder;
+    std::mt19937_64             gen(7U);
+    std::bernoulli_distribution flip(0.02);
+    decoder.setCode(code);
+    for (std::size_t shot = 0; shot < 20U; shot++) {
+        auto err = gf2Vec(code.getN());
+        for (std::size_t i = 0; i < err.size(); i++) {
+            err.at(i) = flip(gen);
+        }
+        decoder.reset();
+        decoder.setGrowth(GrowthVariant::SingleSmallest);
+        decoder.decode(code.getXSyndrome(err));
+        EXPECT_TRUE(decoder.result.matchesSyndrome);
+        EXPECT_EQ(code.getXSyndrome(decoder.result.estimBoolVector), code.getXSyndrome(err));
+    }
+}
+/**
+ * Repetition code with open ends, the error on the unlikely first qubit is explained by the likely other qubits
+ */
+TEST_F(ImprovedUFDtestBase, WeightedGrowth) {
+    gf2Mat      pcm = {{1, 1, 0, 0}, {0, 1, 1, 0}, {0, 0, 1, 1}};
+    auto        code = Code(pcm);
+    UFHeuristic decoder;
+    decoder.setCode(code);
+    const gf2Vec err   = {1, 0, 0, 0};
+    const auto   syndr = code.getXSyndrome(err);
+
+    // uniform weights take the shortest path to the boundary
+    decoder.setGrowth(GrowthVariant::Weighted);
+    decoder.decode(syndr);
+    EXPECT_EQ(decoder.result.estimBoolVector, err);
+
+    decoder.reset();
+    decoder.setErrorProbabilities({1e-6, 0.3, 0.3, 0.3});
+    EXPECT_GT(decoder.getQubitWeights().at(0), 3 * decoder.getQubitWeights().at(1));
+    decoder.setGrowth(GrowthVariant::Weighted);
+    decoder.decode(syndr);
+    const gf2Vec sol = {0, 1, 1, 1};
+    EXPECT_EQ(decoder.result.estimBoolVector, sol);
+
+    decoder.setErrorProbabilities({0.1, 0.1});
+    EXPECT_THROW(decoder.decode(syndr), QeccException);
+    EXPECT_THROW(decoder.setErrorProbabilities({0.0, 0.1, 0.1, 0.1}), QeccException);
+}
+
+/**
+ * Two disjoint cycles, a single defect on the first one has no explanation and its cluster stops growing when it covers the cycle.
+ * The error on the second cycle is still corrected and the result is marked as not matching the syndrome
+ */
+TEST_F(ImprovedUFDtestBase, WeightedGrowthStuckCluster) {
+    gf2Mat      pcm = {{1, 1, 0, 0, 0, 0}, {0, 1, 1, 0, 0, 0}, {1, 0, 1, 0, 0, 0}, {0, 0, 0, 1, 1, 0}, {0, 0, 0, 0, 1, 1}, {0, 0, 0, 1, 0, 1}};
+    auto        code = Code(pcm);
+    UFHeuristic decoder;
+    decoder.setCode(code);
+    const gf2Vec syndr = {1, 0, 0, 1, 1, 0};
+    decoder.setGrowth(GrowthVariant::Weighted);
+    decoder.decode(syndr);
+    EXPECT_FALSE(decoder.result.matchesSyndrome);
+    const gf2Vec corrected(decoder.result.estimBoolVector.begin() + 3, decoder.result.estimBoolVector.end());
+    const gf2Vec sol = {0, 1, 0};
+    EXPECT_EQ(corrected, sol);
+}
+
+TEST_F(ImprovedUFDtestBase, WeightedGrowthMatchesSyndrome) {
+    auto        code = ToricCode32();
+    UFHeuristic decoder;
+    decoder.setCode(code);
+    decoder.setErrorProbabilities(std::vector<double>(code.getN(), 0.01));
+    for (std::size_t i = 0; i < code.getN(); i++) {
+        for (std::size_t j = i; j < code.getN(); j++) {
+            auto err  = gf2Vec(code.getN());
+            err.at(i) = 1;
+            err.at(j) = 1;
+            decoder.reset();
+            decoder.setGrowth(GrowthVariant::Weighted);
+            decoder.decode(code.getXSyndrome(err));
+            EXPECT_EQ(code.getXSyndrome(decoder.result.estimBoolVector), code.getXSyndrome(err));
+        }
+    }
+}
+/**
+ * Three rounds of the toric code, single data and measurement errors are corrected on the space-time graph
+ */
+TEST_F(ImprovedUFDtestBase, SpaceTimeDecoding) {
+    auto                 code  = ToricCode32();
+    const auto           n     = code.getN();
+    const auto           m     = code.gethZ()->nrChecks();
+    const SpaceTimeGraph graph(code, 3U);
+    const auto&          graphCode = graph.getDecodingCode();
+    EXPECT_EQ(graphCode->getN(), 3 * n + 2 * m);
+    EXPECT_EQ(graphCode->gethZ()->nrChecks(), 3 * m);
+    EXPECT_THROW(SpaceTimeGraph(code, 0U), QeccException);
+
+    UFHeuristic decoder;
+    decoder.setCode(graphCode);
+    // a wrong measurement of the first check in the middle round triggers its detectors in the last two rounds
+    std::vector<Gf2Vector> syndromes(3U, Gf2Vector(m));
+    syndromes[1].set(0U);
+    const auto events = graph.getDetectionEvents(syndromes);
+    EXPECT_TRUE(events.get(m));
+    EXPECT_TRUE(events.get(2 * m));
+    decoder.decode(events.toBoolVector());
+    EXPECT_TRUE(decoder.result.estimBoolVector.at(graph.measurementBit(1U, 0U)));
+    EXPECT_FALSE(graph.getDataCorrection(decoder.result.estimBoolVector).any());
+
+    // a data error in the middle round is visible in all later rounds
+    for (std::size_t b = 0; b < n; b++) {
+        auto err  = gf2Vec(n);
+        err.at(b) = 1;
+        const Gf2Vector syndr(code.getXSyndrome(err));
+        decoder.reset();
+        decoder.decode(graph.getDetectionEvents({Gf2Vector(m), syndr, syndr}).toBoolVector());
+        EXPECT_EQ(code.getXSyndrome(graph.getDataCorrection(decoder.result.estimBoolVector).toBoolVector()), code.getXSyndrome(err));
+    }
+}
+/**
+ * Streams of the toric code decoded in windows of three rounds, committing one round per window
+ */
+TEST_F(ImprovedUFDtestBase, SlidingWindowDecoding) {
+    const auto code = std::make_shared<const Code>(ToricCode32());
+    const auto n    = code->getN();
+    const auto m    = code->gethZ()->nrChecks();
+    EXPECT_THROW(SlidingWindowDecoder(code, 3U, 0U), QeccException);
+    EXPECT_THROW(SlidingWindowDecoder(code, 3U, 4U), QeccException);
+
+    SlidingWindowDecoder decoder(code, 3U, 1U);
+    const gf2Vec         trivial(m);
+    std::size_t          committed = 0U;
+    for (std::size_t t = 0; t < 20U; t++) {
+        committed += decoder.pushRound(trivial);
+        EXPECT_LT(decoder.getBufferedRounds(), 3U);
+    }
+    EXPECT_EQ(committed, 18U);
+    EXPECT_EQ(decoder.finish(trivial), 3U);
+    EXPECT_EQ(decoder.getCommittedRounds(), 21U);
+    EXPECT_EQ(decoder.getWindowLatencies().count(), 19U);
+    EXPECT_THROW(decoder.pushRound(trivial), QeccException);
+
+    // a wrong measurement is seen in one window and explained across the commit boundary in the next ones
+    decoder.reset();
+    auto wrong = trivial;
+    wrong.at(0) = 1;
+    for (std::size_t t = 0; t < 20U; t++) {
+        decoder.pushRound(t == 7U ? wrong : trivial);
+    }
+    decoder.finish(trivial);
+    EXPECT_EQ(decoder.getCorrection(), gf2Vec(n));
+
+    // a data error stays in the syndrome of all later rounds
+    for (std::size_t b = 0; b < n; b++) {
+        auto err  = gf2Vec(n);
+        err.at(b) = 1;
+        const auto syndr = code->getXSyndrome(err);
+        decoder.reset();
+        for (std::size_t t = 0; t < 10U; t++) {
+            decoder.pushRound(t < 5U ? trivial : syndr);
+        }
+        decoder.finish(syndr);
+        EXPECT_EQ(code->getXSyndrome(decoder.getCorrection()), syndr);
+    }
+}
+/**
+ * All syndromes of errors of weight at most two are answered by the table with a correction of at most the same weight
+ */
+TEST_F(ImprovedUFDtestBase, LookupTable) {
+    const auto code  = std::make_shared<const Code>(ToricCode32());
+    const auto n     = code->getN();
+    const auto table = std::make_shared<const SyndromeLookupTable>(*code->gethZ(), LookupTableConfig{2U, std::size_t{1U} << 20U, 4U});
+    EXPECT_EQ(table->getMaxWeight(), 2U);
+    EXPECT_GT(table->size(), n);
+    std::vector<std::size_t> correction;
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = i; j < n; j++) {
+            auto err  = gf2Vec(n);
+            err.at(i) = 1;
+            err.at(j) = 1;
+            const Gf2Vector syndr(code->getXSyndrome(err));
+            ASSERT_EQ(table->lookup(syndr, *code->gethZ(), correction), syndr.any());
+            if (syndr.any()) {
+                EXPECT_LE(correction.size(), i == j ? 1U : 2U);
+                EXPECT_EQ(code->gethZ()->getSyndromeFromSupport(correction).toBoolVector(), syndr.toBoolVector());
+            }
+        }
+    }
+
+    UFHeuristic decoder;
+    decoder.setCode(code);
+    EXPECT_THROW(decoder.setLookupTable(std::make_shared<const SyndromeLookupTable>(*ToricCode18().gethZ())), QeccException);
+    decoder.setLookupTable(table);
+    auto err  = gf2Vec(n);
+    err.at(5) = 1;
+    decoder.decode(code->getXSyndrome(err));
+    EXPECT_EQ(decoder.result.estimBoolVector, err);
+
+    // the build does not depend on the number of threads, the memory budget drops the weights that do not fit
+    const std::string path  = "./testLookupTable.bin";
+    const std::string path2 = "./testLookupTable2.bin";
+    table->save(path);
+    SyndromeLookupTable(*code->gethZ(), LookupTableConfig{2U, std::size_t{1U} << 20U, 1U}).save(path2);
+    std::ifstream in(path, std::ios::binary);
+    std::ifstream in2(path2, std::ios::binary);
+    EXPECT_TRUE(std::equal(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>(), std::istreambuf_iterator<char>(in2), std::istreambuf_iterator<char>()));
+    EXPECT_EQ(SyndromeLookupTable(*code->gethZ(), LookupTableConfig{3U, std::size_t{1U} << 16U}).getMaxWeight(), 2U);
+
+    // cached tables are only used for the same check matrix and configuration
+    const auto loaded = SyndromeLookupTable::load(path, *code->gethZ());
+    EXPECT_EQ(loaded.size(), table->size());
+    EXPECT_THROW(SyndromeLookupTable::load(path, *ToricCode18().gethZ()), QeccException);
+    EXPECT_EQ(SyndromeLookupTable::loadOrBuild(path, *code->gethZ(), LookupTableConfig{1U}).getMaxWeight(), 1U);
+    EXPECT_EQ(SyndromeLookupTable::load(path, *code->gethZ()).getMaxWeight(), 1U);
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "garbage";
+    EXPECT_THROW(SyndromeLookupTable::load(path, *code->gethZ()), QeccException);
+    EXPECT_EQ(SyndromeLookupTable::loadOrBuild(path, *code->gethZ()).getMaxWeight(), 2U);
+    std::remove(path.c_str());
+    std::remove(path2.c_str());
+}
 // NOLINTEND(readability-implicit-bool-conversion,modernize-use-bool-literals)